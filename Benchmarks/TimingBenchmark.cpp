@@ -0,0 +1,143 @@
+// Headless timing-accuracy benchmark for the strum scheduler.
+//
+// Plays a chord progression through the processor against a simulated
+// transport at several sample rates and buffer sizes, and reports how far
+// each emitted event landed from its ideal (fractional) sample position,
+// plus the late / clamped / dropped counts.  Exits non-zero if any event
+// was dropped or landed more than half a sample from where it belongs.
+//
+// Usage: GuitarStrumTimingBenchmark [bars]
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PluginProcessor.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Transport that advances by exactly one block per processBlock call
+struct BenchPlayHead : public juce::AudioPlayHead
+{
+    double bpm = 120.0;
+    double ppq = 0.0;
+
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        PositionInfo info;
+        info.setIsPlaying (true);
+        info.setBpm (bpm);
+        info.setPpqPosition (ppq);
+        return info;
+    }
+};
+
+struct TimingTotals
+{
+    uint64_t events = 0, late = 0, clamped = 0, dropped = 0;
+    float maxError = 0.0f;
+    std::array<uint64_t, TIMING_ERROR_BINS> histogram {};
+
+    void add (const BlockDiagnostics& block)
+    {
+        events += block.eventsEmitted;
+        late += block.lateEvents;
+        clamped += block.clampedEvents;
+        dropped += block.droppedEvents;
+        maxError = std::max (maxError, block.maxTimingError);
+
+        for (size_t b = 0; b < histogram.size(); ++b)
+            histogram[b] += block.timingErrorHistogram[b];
+    }
+};
+
+static TimingTotals runProgression (double sampleRate, int blockSize, int bars)
+{
+    static const std::vector<std::vector<int>> chords = {
+        { 48, 52, 55, 60 },   // C
+        { 53, 57, 60, 65 },   // F
+        { 46, 49, 53, 56 },   // Bbm7
+        { 40, 44, 47, 50 },   // E7
+    };
+
+    BenchPlayHead playHead;
+    GuitarStrumSequencerProcessor processor;
+    processor.setPlayHead (&playHead);
+    processor.prepareToPlay (sampleRate, blockSize);
+    processor.diagnosticsEnabled.store (true);
+
+    const double beatsPerSample = playHead.bpm / (60.0 * sampleRate);
+    const double endBeat = bars * 4.0;
+
+    juce::AudioBuffer<float> audio (0, blockSize);
+    juce::MidiBuffer midi;
+    TimingTotals totals;
+    const std::vector<int>* held = nullptr;
+
+    while (playHead.ppq < endBeat)
+    {
+        midi.clear();
+
+        // Change chord on the sample where each bar starts
+        double blockEnd = playHead.ppq + blockSize * beatsPerSample;
+        double nextBar = std::ceil (playHead.ppq / 4.0) * 4.0;
+        if (nextBar < blockEnd)
+        {
+            int offset = juce::jlimit (0, blockSize - 1,
+                                       static_cast<int> ((nextBar - playHead.ppq) / beatsPerSample));
+            const auto& chord = chords[static_cast<size_t> (nextBar / 4.0) % chords.size()];
+
+            if (held != nullptr)
+                for (auto n : *held)
+                    midi.addEvent (juce::MidiMessage::noteOff (1, n), offset);
+            for (auto n : chord)
+                midi.addEvent (juce::MidiMessage::noteOn (1, n, (juce::uint8) 100), offset);
+
+            held = &chord;
+        }
+
+        processor.processBlock (audio, midi);
+        playHead.ppq = blockEnd;
+
+        BlockDiagnostics block;
+        while (processor.popBlockDiagnostics (block))
+            totals.add (block);
+    }
+
+    processor.setPlayHead (nullptr);
+    return totals;
+}
+
+int main (int argc, char* argv[])
+{
+    int bars = 32;
+    if (argc > 1)
+        bars = std::max (1, std::atoi (argv[1]));
+
+    const std::vector<double> sampleRates = { 44100.0, 48000.0, 96000.0 };
+    const std::vector<int> blockSizes = { 16, 32, 64, 128, 256, 441, 512, 1024, 2048 };
+
+    std::printf ("%-8s %-6s %8s %6s %8s %8s %10s   |err| <0.5 <1 <2 <4 <16 <64 <256 >=256 (samples)\n",
+                 "rate", "block", "events", "late", "clamped", "dropped", "max err");
+
+    bool tight = true;
+
+    for (auto sampleRate : sampleRates)
+    {
+        for (auto blockSize : blockSizes)
+        {
+            auto totals = runProgression (sampleRate, blockSize, bars);
+
+            std::printf ("%-8.0f %-6d %8llu %6llu %8llu %8llu %10.3f  ", sampleRate, blockSize,
+                         (unsigned long long) totals.events, (unsigned long long) totals.late,
+                         (unsigned long long) totals.clamped, (unsigned long long) totals.dropped,
+                         static_cast<double> (totals.maxError));
+            for (auto count : totals.histogram)
+                std::printf (" %llu", (unsigned long long) count);
+            std::printf ("\n");
+
+            if (totals.dropped > 0 || totals.maxError > 0.5f)
+                tight = false;
+        }
+    }
+
+    return tight ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+// Offscreen paint benchmark for the editor and its components.
+//
+// Builds each component without a window, renders it into juce::Image
+// targets at several sizes, scale factors and voicing states, and reports
+// the mean and worst paint time per component.
+//
+// Usage: GuitarStrumUIBenchmark [iterations]
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "UI/CustomLookAndFeel.h"
+#include "UI/FretboardComponent.h"
+#include "UI/StepSequencerComponent.h"
+#include "UI/ControlPanelComponent.h"
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+struct PaintStats
+{
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    int count = 0;
+
+    void add (double ms)
+    {
+        totalMs += ms;
+        worstMs = std::max (worstMs, ms);
+        ++count;
+    }
+
+    double meanMs() const { return count > 0 ? totalMs / count : 0.0; }
+};
+
+struct VoicingState
+{
+    const char* name;
+    std::vector<int> notes;   // held MIDI notes, empty = no chord
+};
+
+struct BenchTarget
+{
+    const char* name;
+    juce::Component& component;
+    std::vector<juce::Rectangle<int>> sizes;
+    std::function<void()> refresh;
+};
+
+static double paintOnce (juce::Component& component, float scale)
+{
+    juce::Image image (juce::Image::ARGB,
+                       std::max (1, juce::roundToInt (component.getWidth() * scale)),
+                       std::max (1, juce::roundToInt (component.getHeight() * scale)),
+                       true);
+    juce::Graphics g (image);
+    g.addTransform (juce::AffineTransform::scale (scale));
+
+    auto start = juce::Time::getHighResolutionTicks();
+    component.paintEntireComponent (g, false);
+    auto end = juce::Time::getHighResolutionTicks();
+
+    return juce::Time::highResolutionTicksToSeconds (end - start) * 1000.0;
+}
+
+// Feeds note-offs for the previous chord and note-ons for the next one
+// through the processor so the voicing telemetry reflects the new state
+static void holdChord (GuitarStrumSequencerProcessor& processor,
+                       std::vector<int>& heldNotes, const std::vector<int>& notes)
+{
+    juce::AudioBuffer<float> audio (0, 256);
+    juce::MidiBuffer midi;
+
+    for (auto n : heldNotes)
+        midi.addEvent (juce::MidiMessage::noteOff (1, n), 0);
+    for (auto n : notes)
+        midi.addEvent (juce::MidiMessage::noteOn (1, n, (juce::uint8) 100), 1);
+
+    processor.processBlock (audio, midi);
+    heldNotes = notes;
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    int iterations = 50;
+    if (argc > 1)
+        iterations = std::max (1, std::atoi (argv[1]));
+
+    GuitarStrumSequencerProcessor processor;
+    processor.prepareToPlay (44100.0, 256);
+
+    CustomLookAndFeel lookAndFeel;
+    GuitarStrumSequencerEditor editor (processor);
+    FretboardComponent fretboard (processor);
+    StepSequencerComponent stepSequencer (processor.getAPVTS(), processor.currentStepForUI);
+    ControlPanelComponent controlPanel (processor.getAPVTS(), processor);
+
+    fretboard.setLookAndFeel (&lookAndFeel);
+    stepSequencer.setLookAndFeel (&lookAndFeel);
+    controlPanel.setLookAndFeel (&lookAndFeel);
+
+    std::vector<BenchTarget> targets = {
+        { "Editor", editor,
+          { { 0, 0, 700, 500 }, { 0, 0, 900, 640 }, { 0, 0, 1400, 1000 } },
+          [&] { editor.refreshComponents(); } },
+        { "Fretboard", fretboard,
+          { { 0, 0, 320, 160 }, { 0, 0, 480, 240 }, { 0, 0, 800, 400 } },
+          [&] { fretboard.refresh(); } },
+        { "StepSequencer", stepSequencer,
+          { { 0, 0, 700, 220 }, { 0, 0, 900, 280 }, { 0, 0, 1400, 440 } },
+          [&] { stepSequencer.refresh(); } },
+        { "ControlPanel", controlPanel,
+          { { 0, 0, 700, 240 }, { 0, 0, 900, 320 }, { 0, 0, 1400, 480 } },
+          [&] { controlPanel.refresh(); } },
+    };
+
+    const std::vector<float> scales = { 1.0f, 1.5f, 2.0f };
+
+    const std::vector<VoicingState> voicings = {
+        { "none",  {} },
+        { "C",     { 48, 52, 55, 60 } },
+        { "F",     { 53, 57, 60, 65 } },
+        { "Bbm7",  { 46, 49, 53, 56 } },
+        { "E7",    { 40, 44, 47, 50 } },
+    };
+
+    std::printf ("%-14s %-10s %-6s %10s %10s\n", "component", "size", "scale", "mean ms", "worst ms");
+
+    std::vector<int> heldNotes;
+
+    for (auto& target : targets)
+    {
+        PaintStats componentStats;
+
+        for (auto& size : target.sizes)
+        {
+            target.component.setBounds (size);
+
+            for (auto scale : scales)
+            {
+                PaintStats stats;
+
+                for (auto& voicing : voicings)
+                {
+                    holdChord (processor, heldNotes, voicing.notes);
+
+                    for (int i = 0; i < iterations; ++i)
+                    {
+                        // Walk the step highlight so step-dependent drawing is exercised
+                        processor.currentStepForUI.store (i % StepSequencer::DEFAULT_STEPS);
+                        target.refresh();
+
+                        double ms = paintOnce (target.component, scale);
+                        stats.add (ms);
+                        componentStats.add (ms);
+                    }
+                }
+
+                auto sizeText = juce::String (size.getWidth()) + "x" + juce::String (size.getHeight());
+                std::printf ("%-14s %-10s %-6.1f %10.4f %10.4f\n", target.name,
+                             sizeText.toRawUTF8(), static_cast<double> (scale),
+                             stats.meanMs(), stats.worstMs);
+            }
+        }
+
+        std::printf ("%-14s %-10s %-6s %10.4f %10.4f\n\n", target.name, "all", "all",
+                     componentStats.meanMs(), componentStats.worstMs);
+    }
+
+    fretboard.setLookAndFeel (nullptr);
+    stepSequencer.setLookAndFeel (nullptr);
+    controlPanel.setLookAndFeel (nullptr);
+
+    return 0;
+}
@@ -0,0 +1,359 @@
+#include "BlackBoxRecorder.h"
+
+namespace
+{
+    constexpr int fileMagic = 0x42425347;   // "GSBB"
+    constexpr int fileVersion = 2;   // 2: adds the non-realtime flag
+}
+
+// ── Recording file format ─────────────────────────────────────────────
+
+std::vector<BlackBoxRecording::MidiEvent> BlackBoxRecording::toEvents (const juce::MidiBuffer& buffer)
+{
+    std::vector<MidiEvent> events;
+    for (const auto metadata : buffer)
+    {
+        if (metadata.numBytes > 3)
+            continue;   // sysex is not recorded
+
+        MidiEvent e { metadata.samplePosition, { 0, 0, 0 }, static_cast<juce::uint8> (metadata.numBytes) };
+        std::copy (metadata.data, metadata.data + metadata.numBytes, e.bytes);
+        events.push_back (e);
+    }
+    return events;
+}
+
+static void writeEvents (juce::OutputStream& out, const std::vector<BlackBoxRecording::MidiEvent>& events)
+{
+    for (const auto& e : events)
+    {
+        out.writeInt (e.samplePosition);
+        out.writeByte (static_cast<char> (e.size));
+        out.write (e.bytes, 3);
+    }
+}
+
+static bool readEvents (juce::InputStream& in, int count, std::vector<BlackBoxRecording::MidiEvent>& events)
+{
+    if (count < 0 || count > 65536)
+        return false;
+
+    events.resize (static_cast<size_t> (count));
+    for (auto& e : events)
+    {
+        e.samplePosition = in.readInt();
+        e.size = static_cast<juce::uint8> (in.readByte());
+        if (in.read (e.bytes, 3) != 3 || e.size == 0 || e.size > 3)
+            return false;
+    }
+    return true;
+}
+
+bool BlackBoxRecording::writeTo (juce::OutputStream& out) const
+{
+    out.writeInt (fileMagic);
+    out.writeInt (fileVersion);
+    out.writeDouble (sampleRate);
+    out.writeByte (nonRealtime ? 1 : 0);
+    out.writeByte (startsAtPrepare ? 1 : 0);
+    out.writeInt (static_cast<int> (pluginState.getSize()));
+    out.write (pluginState.getData(), pluginState.getSize());
+
+    out.writeInt (static_cast<int> (blocks.size()));
+    for (const auto& block : blocks)
+    {
+        out.writeInt (block.numSamples);
+        out.writeByte (static_cast<char> (block.flags));
+        out.writeDouble (block.bpm);
+        out.writeDouble (block.ppq);
+        out.writeDouble (block.loopStart);
+        out.writeDouble (block.loopEnd);
+        out.writeInt (static_cast<int> (block.input.size()));
+        out.writeInt (static_cast<int> (block.output.size()));
+        writeEvents (out, block.input);
+        writeEvents (out, block.output);
+    }
+
+    out.flush();
+    return true;
+}
+
+bool BlackBoxRecording::readFrom (juce::InputStream& in, BlackBoxRecording& recording)
+{
+    if (in.readInt() != fileMagic)
+        return false;
+
+    auto version = in.readInt();
+    if (version < 1 || version > fileVersion)
+        return false;
+
+    recording.sampleRate = in.readDouble();
+    recording.nonRealtime = version >= 2 && in.readByte() != 0;
+    recording.startsAtPrepare = in.readByte() != 0;
+
+    auto stateSize = in.readInt();
+    if (stateSize < 0 || stateSize > (1 << 24))
+        return false;
+
+    recording.pluginState.setSize (static_cast<size_t> (stateSize));
+    if (in.read (recording.pluginState.getData(), stateSize) != stateSize)
+        return false;
+
+    auto numBlocks = in.readInt();
+    if (numBlocks < 0)
+        return false;
+
+    recording.blocks.clear();
+    for (int i = 0; i < numBlocks && ! in.isExhausted(); ++i)
+    {
+        Block block;
+        block.numSamples = in.readInt();
+        block.flags = static_cast<juce::uint8> (in.readByte());
+        block.bpm = in.readDouble();
+        block.ppq = in.readDouble();
+        block.loopStart = in.readDouble();
+        block.loopEnd = in.readDouble();
+        auto numInput = in.readInt();
+        auto numOutput = in.readInt();
+
+        if (block.numSamples <= 0
+            || ! readEvents (in, numInput, block.input)
+            || ! readEvents (in, numOutput, block.output))
+            return false;
+
+        recording.blocks.push_back (std::move (block));
+    }
+
+    return static_cast<int> (recording.blocks.size()) == numBlocks;
+}
+
+// ── Recorder ─────────────────────────────────────────────────────────
+
+BlackBoxRecorder::BlackBoxRecorder (double seconds)
+    : juce::Thread ("Black box recorder"),
+      historySeconds (seconds)
+{
+}
+
+BlackBoxRecorder::~BlackBoxRecorder()
+{
+    stopThread (1000);
+}
+
+void BlackBoxRecorder::setEnabled (bool shouldRecord)
+{
+    if (shouldRecord == isEnabled())
+        return;
+
+    enabled.store (shouldRecord, std::memory_order_relaxed);
+
+    if (shouldRecord)
+    {
+        startThread();
+    }
+    else
+    {
+        // With the writer stopped, this thread takes over as the consumer
+        stopThread (1000);
+        drainRecords();
+    }
+}
+
+void BlackBoxRecorder::prepare (double sampleRate, bool nonRealtime)
+{
+    // prepareToPlay never runs alongside processBlock, so this thread can
+    // act as the producer here
+    Record record {};
+    record.kind = Record::Prepared;
+    record.sampleRate = sampleRate;
+    record.nonRealtime = nonRealtime;
+    ring.push (record);
+
+    gapPending = false;
+    blockOpen = false;
+}
+
+bool BlackBoxRecorder::pushMidi (Record::Kind kind, const juce::MidiBuffer& buffer) noexcept
+{
+    for (const auto metadata : buffer)
+    {
+        if (metadata.numBytes > 3)
+            continue;
+
+        Record record {};
+        record.kind = kind;
+        record.size = static_cast<juce::uint8> (metadata.numBytes);
+        std::copy (metadata.data, metadata.data + metadata.numBytes, record.bytes);
+        record.value = metadata.samplePosition;
+
+        if (! ring.push (record))
+            return false;
+    }
+    return true;
+}
+
+void BlackBoxRecorder::recordInput (int numSamples, juce::AudioPlayHead* playHead,
+                                    const juce::MidiBuffer& input) noexcept
+{
+    blockOpen = false;
+
+    if (! isEnabled())
+    {
+        gapPending = true;
+        return;
+    }
+
+    // The whole block goes in or none of it does
+    if (ring.getFreeSpace() < static_cast<size_t> (input.getNumEvents()) + 1)
+    {
+        gapPending = true;
+        return;
+    }
+
+    Record block {};
+    block.kind = Record::BlockStart;
+    block.value = numSamples;
+    block.flags = gapPending ? BlackBoxRecording::AfterGap : 0;
+
+    if (playHead != nullptr)
+    {
+        if (auto pos = playHead->getPosition())
+        {
+            block.flags |= BlackBoxRecording::HasPosition;
+            if (pos->getIsPlaying())
+                block.flags |= BlackBoxRecording::IsPlaying;
+            if (pos->getIsLooping())
+                block.flags |= BlackBoxRecording::IsLooping;
+            if (auto bpm = pos->getBpm())
+            {
+                block.flags |= BlackBoxRecording::HasBpm;
+                block.bpm = *bpm;
+            }
+            if (auto ppq = pos->getPpqPosition())
+            {
+                block.flags |= BlackBoxRecording::HasPpq;
+                block.ppq = *ppq;
+            }
+            if (auto loop = pos->getLoopPoints())
+            {
+                block.flags |= BlackBoxRecording::HasLoopPoints;
+                block.loopStart = loop->ppqStart;
+                block.loopEnd = loop->ppqEnd;
+            }
+        }
+    }
+
+    ring.push (block);
+    pushMidi (Record::InputMidi, input);
+
+    gapPending = false;
+    blockOpen = true;
+}
+
+void BlackBoxRecorder::recordOutput (const juce::MidiBuffer& output) noexcept
+{
+    if (! blockOpen)
+        return;
+
+    blockOpen = false;
+
+    // A block with missing output can't be compared on replay
+    if (! pushMidi (Record::OutputMidi, output))
+        gapPending = true;
+}
+
+void BlackBoxRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        drainRecords();
+        wait (50);
+    }
+}
+
+void BlackBoxRecorder::drainRecords()
+{
+    std::lock_guard<std::mutex> lock (historyLock);
+
+    Record record;
+    while (ring.pop (record))
+    {
+        switch (record.kind)
+        {
+            case Record::Prepared:
+                history.clear();
+                historySamples = 0;
+                historyStartsAtPrepare = true;
+                currentSampleRate.store (record.sampleRate, std::memory_order_relaxed);
+                currentNonRealtime.store (record.nonRealtime, std::memory_order_relaxed);
+                break;
+
+            case Record::BlockStart:
+            {
+                if ((record.flags & BlackBoxRecording::AfterGap) != 0)
+                {
+                    // Replay needs a contiguous run of blocks
+                    history.clear();
+                    historySamples = 0;
+                    historyStartsAtPrepare = false;
+                }
+
+                BlackBoxRecording::Block block;
+                block.numSamples = record.value;
+                block.flags = record.flags;
+                block.bpm = record.bpm;
+                block.ppq = record.ppq;
+                block.loopStart = record.loopStart;
+                block.loopEnd = record.loopEnd;
+                history.push_back (std::move (block));
+                historySamples += record.value;
+                break;
+            }
+
+            case Record::InputMidi:
+            case Record::OutputMidi:
+            {
+                if (history.empty())
+                    break;
+
+                BlackBoxRecording::MidiEvent e { record.value,
+                                                 { record.bytes[0], record.bytes[1], record.bytes[2] },
+                                                 record.size };
+                auto& events = record.kind == Record::InputMidi ? history.back().input
+                                                                : history.back().output;
+                events.push_back (e);
+                break;
+            }
+        }
+    }
+
+    // Keep only the most recent historySeconds
+    auto maxSamples = static_cast<juce::int64> (historySeconds * currentSampleRate.load (std::memory_order_relaxed));
+    while (history.size() > 1 && historySamples - history.front().numSamples >= maxSamples)
+    {
+        historySamples -= history.front().numSamples;
+        history.pop_front();
+        historyStartsAtPrepare = false;
+    }
+}
+
+bool BlackBoxRecorder::dump (const juce::File& file, const juce::MemoryBlock& pluginState)
+{
+    BlackBoxRecording recording;
+    recording.sampleRate = currentSampleRate.load (std::memory_order_relaxed);
+    recording.nonRealtime = currentNonRealtime.load (std::memory_order_relaxed);
+    recording.pluginState = pluginState;
+
+    {
+        std::lock_guard<std::mutex> lock (historyLock);
+        recording.startsAtPrepare = historyStartsAtPrepare;
+        recording.blocks.assign (history.begin(), history.end());
+    }
+
+    file.deleteFile();
+    juce::FileOutputStream out (file);
+    if (! out.openedOk())
+        return false;
+
+    return recording.writeTo (out);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "SpscFifo.h"
+#include <deque>
+#include <mutex>
+
+// A captured stretch of processBlock calls: the input MIDI, transport state
+// and block size of every block, plus the MIDI the plugin produced, so the
+// session can be replayed headlessly and the output compared.
+struct BlackBoxRecording
+{
+    struct MidiEvent
+    {
+        int samplePosition;
+        juce::uint8 bytes[3];
+        juce::uint8 size;
+    };
+
+    enum BlockFlags : juce::uint8
+    {
+        HasPosition   = 1 << 0,
+        IsPlaying     = 1 << 1,
+        IsLooping     = 1 << 2,
+        HasBpm        = 1 << 3,
+        HasPpq        = 1 << 4,
+        HasLoopPoints = 1 << 5,
+        AfterGap      = 1 << 6    // blocks were lost just before this one
+    };
+
+    struct Block
+    {
+        int numSamples = 0;
+        juce::uint8 flags = 0;
+        double bpm = 0.0, ppq = 0.0, loopStart = 0.0, loopEnd = 0.0;
+        std::vector<MidiEvent> input, output;
+    };
+
+    double sampleRate = 44100.0;
+    bool nonRealtime = false;       // prepared for an offline render
+    bool startsAtPrepare = false;   // first block is the first after prepareToPlay
+    juce::MemoryBlock pluginState;  // getStateInformation() at dump time
+    std::vector<Block> blocks;
+
+    bool writeTo (juce::OutputStream& out) const;
+    static bool readFrom (juce::InputStream& in, BlackBoxRecording& recording);
+
+    static std::vector<MidiEvent> toEvents (const juce::MidiBuffer& buffer);
+};
+
+// Keeps the last few seconds of processBlock input/output for post-mortem
+// replay.  The audio thread writes fixed-size records into a preallocated
+// SPSC ring; a background thread assembles them into blocks and trims the
+// history, and dump() writes it to disk on demand.
+class BlackBoxRecorder : private juce::Thread
+{
+public:
+    explicit BlackBoxRecorder (double historySeconds = 30.0);
+    ~BlackBoxRecorder() override;
+
+    // Message thread
+    void setEnabled (bool shouldRecord);
+    bool isEnabled() const { return enabled.load (std::memory_order_relaxed); }
+    bool dump (const juce::File& file, const juce::MemoryBlock& pluginState);
+
+    // Called from prepareToPlay: restarts the history at the new sample rate
+    // and processing mode
+    void prepare (double sampleRate, bool nonRealtime);
+
+    // Audio thread, around each processBlock: no-ops while disabled
+    void recordInput (int numSamples, juce::AudioPlayHead* playHead, const juce::MidiBuffer& input) noexcept;
+    void recordOutput (const juce::MidiBuffer& output) noexcept;
+
+private:
+    struct Record
+    {
+        enum Kind : juce::uint8 { BlockStart, InputMidi, OutputMidi, Prepared };
+
+        Kind kind;
+        juce::uint8 flags;
+        juce::uint8 size;
+        juce::uint8 bytes[3];
+        int32_t value;            // numSamples or sample position
+        bool nonRealtime;         // Prepared only
+        double sampleRate;        // Prepared only
+        double bpm, ppq, loopStart, loopEnd;
+    };
+
+    bool pushMidi (Record::Kind kind, const juce::MidiBuffer& buffer) noexcept;
+    void run() override;
+    void drainRecords();
+
+    const double historySeconds;
+    std::atomic<bool> enabled { false };
+    std::atomic<double> currentSampleRate { 44100.0 };
+    std::atomic<bool> currentNonRealtime { false };
+
+    // Audio thread only
+    bool gapPending = false;
+    bool blockOpen = false;
+
+    SpscFifo<Record, 16384> ring;
+
+    // Writer thread, guarded for dump()
+    std::mutex historyLock;
+    std::deque<BlackBoxRecording::Block> history;
+    juce::int64 historySamples = 0;
+    bool historyStartsAtPrepare = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BlackBoxRecorder)
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Emitted-minus-ideal sample position of scheduled events, binned by
+// magnitude.  Bin upper edges in samples: 0.5, 1, 2, 4, 16, 64, 256, ∞ —
+// everything in bin 0 is as tight as integer sample positions allow.
+static constexpr int TIMING_ERROR_BINS = 8;
+
+inline int getTimingErrorBin (double absErrorSamples)
+{
+    static constexpr double edges[TIMING_ERROR_BINS - 1] = { 0.5, 1.0, 2.0, 4.0, 16.0, 64.0, 256.0 };
+
+    int bin = 0;
+    while (bin < TIMING_ERROR_BINS - 1 && absErrorSamples > edges[bin])
+        ++bin;
+    return bin;
+}
+
+// Hot-path counters for one processBlock call.  Filled on the audio thread
+// and handed to the diagnostics panel through an SPSC ring when
+// diagnostics are switched on.
+struct BlockDiagnostics
+{
+    float processMicros = 0.0f;   // wall time spent in processBlock
+    uint32_t numSamples = 0;
+    uint32_t voicerCalls = 0;     // findBestPosition calls
+    uint32_t cacheHits = 0;       // findBestVoicing served from the cache
+    uint32_t cacheMisses = 0;
+    uint32_t searchNodes = 0;     // candidate voicings scored
+    uint32_t pendingDepth = 0;    // pending events left after emission
+    uint32_t eventsEmitted = 0;   // pending events written to the MidiBuffer
+    uint32_t retriggers = 0;
+
+    // Timing accuracy of the events emitted in this block
+    uint32_t lateEvents = 0;      // past-due, moved to sample 0
+    uint32_t clampedEvents = 0;   // rounded past the block end, pulled to the last sample
+    uint32_t droppedEvents = 0;   // too stale to emit, or pruned as out of range
+    float maxTimingError = 0.0f;  // worst |emitted - ideal|, in samples
+    std::array<uint16_t, TIMING_ERROR_BINS> timingErrorHistogram {};
+    bool idle = false;            // block took the idle fast path
+};
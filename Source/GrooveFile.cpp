@@ -0,0 +1,119 @@
+#include "GrooveFile.h"
+
+const juce::StringArray GrooveFile::presetNames { "Off", "Swing", "Laid Back", "Push" };
+
+namespace
+{
+    // Every grid step of the clip gets its own groove step, so grids that
+    // don't divide a bar (dotted, odd tuplets) stay aligned with the clip.
+    // Clips too long for that fold over the longest whole number of bars
+    // that fits, or failing that over as many steps as a groove can hold
+    int getGrooveLength (double clipBeats, double gridBeats)
+    {
+        int clipSteps = juce::jmax (1, juce::roundToInt (clipBeats / gridBeats));
+        if (clipSteps <= GrooveTemplate::MAX_STEPS)
+            return clipSteps;
+
+        for (int steps = GrooveTemplate::MAX_STEPS; steps > 0; --steps)
+        {
+            double bars = steps * gridBeats / 4.0;
+            if (std::abs (bars - std::round (bars)) < 1.0e-6 && bars >= 1.0)
+                return steps;
+        }
+
+        return GrooveTemplate::MAX_STEPS;
+    }
+
+    bool extractFromMidi (const juce::File& file, double gridBeats, GrooveTemplate& groove, juce::String& error)
+    {
+        juce::FileInputStream in (file);
+        juce::MidiFile midiFile;
+        if (! in.openedOk() || ! midiFile.readFrom (in))
+        {
+            error = "Not a readable MIDI file";
+            return false;
+        }
+
+        int ticksPerQuarter = midiFile.getTimeFormat();
+        if (ticksPerQuarter <= 0)
+        {
+            error = "SMPTE time format is not supported";
+            return false;
+        }
+
+        std::vector<GrooveTemplate::Hit> hits;
+        double clipBeats = 0.0;
+        for (int t = 0; t < midiFile.getNumTracks(); ++t)
+        {
+            const auto* track = midiFile.getTrack (t);
+            clipBeats = juce::jmax (clipBeats, track->getEndTime() / ticksPerQuarter);
+
+            for (const auto* e : *track)
+                if (e->message.isNoteOn())
+                    hits.push_back ({ e->message.getTimeStamp() / ticksPerQuarter, e->message.getVelocity() });
+        }
+
+        if (hits.empty())
+        {
+            error = "No notes to take a groove from";
+            return false;
+        }
+
+        groove = GrooveTemplate::extract (std::move (hits), gridBeats, getGrooveLength (clipBeats, gridBeats));
+        return true;
+    }
+}
+
+bool GrooveFile::load (const juce::File& file, double gridBeats, GrooveTemplate& groove, juce::String& error)
+{
+    if (file.hasFileExtension ("mid;midi"))
+        return extractFromMidi (file, gridBeats, groove, error);
+
+    if (! fromJson (juce::JSON::parse (file), groove))
+    {
+        error = "Expected a JSON object with a \"steps\" array";
+        return false;
+    }
+    return true;
+}
+
+bool GrooveFile::fromJson (const juce::var& json, GrooveTemplate& groove)
+{
+    auto* steps = json["steps"].getArray();
+    if (steps == nullptr)
+        return false;
+
+    groove = {};
+    groove.numSteps = juce::jmin (GrooveTemplate::MAX_STEPS, steps->size());
+
+    for (int i = 0; i < groove.numSteps; ++i)
+    {
+        const auto& step = steps->getReference (i);
+        auto& out = groove.steps[static_cast<size_t> (i)];
+
+        out.timing = static_cast<float> (step.getProperty ("timing", 0.0));
+        out.velocity = static_cast<float> (step.getProperty ("velocity", 1.0));
+        out.strumSpeed = static_cast<float> (step.getProperty ("strumSpeed", 1.0));
+        out = out.limited();
+    }
+
+    return true;
+}
+
+juce::String GrooveFile::toJson (const GrooveTemplate& groove)
+{
+    juce::Array<juce::var> steps;
+    for (int i = 0; i < groove.numSteps; ++i)
+    {
+        const auto& step = groove.steps[static_cast<size_t> (i)];
+        auto* object = new juce::DynamicObject();
+        object->setProperty ("timing", step.timing);
+        object->setProperty ("velocity", step.velocity);
+        object->setProperty ("strumSpeed", step.strumSpeed);
+        steps.add (juce::var (object));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty ("steps", steps);
+    return juce::JSON::toString (juce::var (root), true);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "GrooveTemplate.h"
+
+// Groove templates on disk: JSON with one object per step,
+//   { "steps": [ { "timing": 0.0, "velocity": 1.0, "strumSpeed": 1.0 }, ... ] }
+// or a reference performance as a MIDI file, with one groove step per grid
+// step of the clip (long clips fold over a whole number of bars)
+class GrooveFile
+{
+public:
+    static const juce::StringArray presetNames;   // by GrooveTemplate preset index
+
+    // gridBeats sets the step size a MIDI reference is measured against
+    static bool load (const juce::File& file, double gridBeats, GrooveTemplate& groove, juce::String& error);
+
+    static juce::String toJson (const GrooveTemplate& groove);
+    static bool fromJson (const juce::var& json, GrooveTemplate& groove);
+};
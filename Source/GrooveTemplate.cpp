@@ -0,0 +1,109 @@
+#include "GrooveTemplate.h"
+#include <algorithm>
+#include <cmath>
+
+bool GrooveTemplate::operator== (const GrooveTemplate& other) const
+{
+    return numSteps == other.numSteps
+        && std::equal (steps.begin(), steps.begin() + numSteps, other.steps.begin());
+}
+
+GrooveTemplate::Step GrooveTemplate::Step::limited() const
+{
+    return { std::clamp (timing, -MAX_TIMING, MAX_TIMING),
+             std::clamp (velocity, 0.0f, MAX_VELOCITY),
+             std::clamp (strumSpeed, 0.0f, MAX_STRUM_SPEED) };
+}
+
+const GrooveTemplate& GrooveTemplate::getPreset (int index)
+{
+    static const std::array<GrooveTemplate, NUM_PRESETS> presets = []
+    {
+        std::array<GrooveTemplate, NUM_PRESETS> p {};
+
+        // Swing: off-beats a triplet late and lighter
+        p[1].numSteps = 2;
+        p[1].steps[1] = { 0.33f, 0.85f, 1.0f };
+
+        // Laid back: everything drags, strums roll slower
+        p[2].numSteps = 4;
+        p[2].steps[0] = { 0.06f, 1.0f, 1.3f };
+        p[2].steps[1] = { 0.12f, 0.8f, 1.4f };
+        p[2].steps[2] = { 0.08f, 0.9f, 1.3f };
+        p[2].steps[3] = { 0.14f, 0.8f, 1.4f };
+
+        // Push: off-beats anticipate with a quick, accented flick
+        p[3].numSteps = 2;
+        p[3].steps[0] = { 0.0f, 1.0f, 1.0f };
+        p[3].steps[1] = { -0.1f, 1.1f, 0.7f };
+
+        return p;
+    }();
+
+    return presets[static_cast<size_t> (std::clamp (index, 0, NUM_PRESETS - 1))];
+}
+
+GrooveTemplate GrooveTemplate::extract (std::vector<Hit> hits, double gridBeats, int numSteps)
+{
+    GrooveTemplate groove;
+    if (hits.empty() || gridBeats <= 0.0)
+        return groove;
+
+    groove.numSteps = std::clamp (numSteps, 1, MAX_STEPS);
+    std::sort (hits.begin(), hits.end(), [] (const Hit& a, const Hit& b) { return a.beat < b.beat; });
+
+    struct Strum { double cell; double first; double last; double velocity; int count; };
+    std::vector<Strum> strums;
+
+    for (const auto& hit : hits)
+    {
+        double cell = std::round (hit.beat / gridBeats);
+        if (strums.empty() || strums.back().cell != cell)
+            strums.push_back ({ cell, hit.beat, hit.beat, 0.0, 0 });
+
+        auto& strum = strums.back();
+        strum.last = hit.beat;
+        strum.velocity += hit.velocity;
+        ++strum.count;
+    }
+
+    double meanVelocity = 0.0, meanSpread = 0.0;
+    for (auto& strum : strums)
+    {
+        strum.velocity /= strum.count;
+        meanVelocity += strum.velocity;
+        meanSpread += strum.last - strum.first;
+    }
+    meanVelocity /= static_cast<double> (strums.size());
+    meanSpread /= static_cast<double> (strums.size());
+
+    std::array<double, MAX_STEPS> timing {}, velocity {}, spread {};
+    std::array<int, MAX_STEPS> counts {};
+
+    for (const auto& strum : strums)
+    {
+        auto cell = static_cast<long long> (strum.cell);
+        auto index = static_cast<size_t> (((cell % groove.numSteps) + groove.numSteps) % groove.numSteps);
+        timing[index] += strum.first / gridBeats - strum.cell;
+        velocity[index] += strum.velocity;
+        spread[index] += strum.last - strum.first;
+        ++counts[index];
+    }
+
+    for (size_t i = 0; i < static_cast<size_t> (groove.numSteps); ++i)
+    {
+        if (counts[i] == 0)
+            continue;   // never played: stays straight
+
+        double n = counts[i];
+        groove.steps[i].timing = static_cast<float> (timing[i] / n);
+        if (meanVelocity > 0.0)
+            groove.steps[i].velocity = static_cast<float> (velocity[i] / n / meanVelocity);
+        if (meanSpread > 0.0)
+            groove.steps[i].strumSpeed = static_cast<float> (spread[i] / n / meanSpread);
+
+        groove.steps[i] = groove.steps[i].limited();
+    }
+
+    return groove;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+// A groove: how far each step sits off the grid and how hard and how fast
+// it is strummed, as deviations from a straight performance.  The steps
+// cycle over a pattern's steps, so a 2-step groove swings every pair.
+struct GrooveTemplate
+{
+    static constexpr int MAX_STEPS = 64;
+
+    struct Step
+    {
+        float timing = 0.0f;       // in grid steps, + = late
+        float velocity = 1.0f;     // scales the step velocity
+        float strumSpeed = 1.0f;   // scales the delay between strings
+
+        // Every groove step is kept within these, whether loaded or extracted
+        static constexpr float MAX_TIMING = 0.5f;
+        static constexpr float MAX_VELOCITY = 2.0f;
+        static constexpr float MAX_STRUM_SPEED = 4.0f;
+        Step limited() const;
+
+        bool operator== (const Step& other) const
+        {
+            return timing == other.timing && velocity == other.velocity && strumSpeed == other.strumSpeed;
+        }
+    };
+
+    int numSteps = 0;   // 0 = straight
+    std::array<Step, MAX_STEPS> steps {};
+
+    bool operator== (const GrooveTemplate& other) const;
+    bool operator!= (const GrooveTemplate& other) const { return ! (*this == other); }
+
+    // Built-in grooves, indexed by the groove parameter (0 = straight)
+    static constexpr int NUM_PRESETS = 4;
+    static const GrooveTemplate& getPreset (int index);
+
+    // Played notes from a reference performance, e.g. a MIDI clip
+    struct Hit
+    {
+        double beat;
+        int velocity;
+    };
+
+    // Averages each grid step's deviation over every numSteps-long repeat
+    // of the reference, counted in grid steps from its start:
+    // notes landing in the same grid cell are one strum, timed by its first
+    // note and with its spread compared against the mean spread
+    static GrooveTemplate extract (std::vector<Hit> hits, double gridBeats, int numSteps);
+};
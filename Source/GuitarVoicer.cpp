@@ -1,4 +1,5 @@
 #include "GuitarVoicer.h"
+#include <cstdio>
 
 const std::array<std::array<int, GuitarVoicer::NUM_STRINGS>, GuitarVoicer::NUM_TUNINGS> GuitarVoicer::TUNINGS = {{
     {{ 40, 45, 50, 55, 59, 64 }},  // Standard:       E2 A2 D3 G3 B3 E4
@@ -10,6 +11,35 @@ const std::array<std::array<int, GuitarVoicer::NUM_STRINGS>, GuitarVoicer::NUM_T
 
 const std::array<int, 8> GuitarVoicer::CC_MAP = {{ 85, 86, 87, 102, 103, 104, 105, 106 }};
 
+namespace
+{
+    const char* const noteNames[12] = {
+        "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B"
+    };
+
+    // Chord qualities as interval bitmasks above the root (bit 0 = root),
+    // richest first so a superset wins over its triad
+    struct Quality { int intervals; const char* suffix; };
+    const Quality qualities[] = {
+        { (1 << 0) | (1 << 4) | (1 << 7) | (1 << 10) | (1 << 2), "9" },
+        { (1 << 0) | (1 << 4) | (1 << 7) | (1 << 11), "maj7" },
+        { (1 << 0) | (1 << 4) | (1 << 7) | (1 << 10), "7" },
+        { (1 << 0) | (1 << 3) | (1 << 7) | (1 << 10), "m7" },
+        { (1 << 0) | (1 << 3) | (1 << 6) | (1 << 10), "m7b5" },
+        { (1 << 0) | (1 << 3) | (1 << 6) | (1 << 9),  "dim7" },
+        { (1 << 0) | (1 << 4) | (1 << 7) | (1 << 9),  "6" },
+        { (1 << 0) | (1 << 3) | (1 << 7) | (1 << 9),  "m6" },
+        { (1 << 0) | (1 << 4) | (1 << 7) | (1 << 2),  "add9" },
+        { (1 << 0) | (1 << 4) | (1 << 7), "" },
+        { (1 << 0) | (1 << 3) | (1 << 7), "m" },
+        { (1 << 0) | (1 << 3) | (1 << 6), "dim" },
+        { (1 << 0) | (1 << 4) | (1 << 8), "aug" },
+        { (1 << 0) | (1 << 2) | (1 << 7), "sus2" },
+        { (1 << 0) | (1 << 5) | (1 << 7), "sus4" },
+        { (1 << 0) | (1 << 7), "5" },
+    };
+}
+
 GuitarVoicer::GuitarVoicer()
 {
     reset();
@@ -18,6 +48,7 @@ GuitarVoicer::GuitarVoicer()
 void GuitarVoicer::reset()
 {
     currentPosition = -1;
+    previousVoicing = {};
     voicingCache.clear();
 }
 
@@ -31,6 +62,94 @@ std::array<int, GuitarVoicer::NUM_STRINGS> GuitarVoicer::getStringOpenPitches (i
     return result;
 }
 
+void GuitarVoicer::getChordName (const std::vector<int>& pitchClasses, int rootPitchClass,
+                                 char* dest, size_t destSize)
+{
+    if (dest == nullptr || destSize == 0)
+        return;
+
+    dest[0] = '\0';
+    if (pitchClasses.empty() || rootPitchClass < 0)
+        return;
+
+    int intervals = 0;
+    for (auto pc : pitchClasses)
+        intervals |= 1 << (((pc - rootPitchClass) % 12 + 12) % 12);
+
+    const char* suffix = "";
+    for (auto& q : qualities)
+    {
+        if ((intervals & q.intervals) == q.intervals)
+        {
+            suffix = q.suffix;
+            break;
+        }
+    }
+
+    std::snprintf (dest, destSize, "%s%s", noteNames[rootPitchClass % 12], suffix);
+}
+
+bool GuitarVoicer::parseChordName (const std::string& name, std::vector<int>& pitchClasses,
+                                   int& rootPitchClass)
+{
+    static const int letterPitchClasses[7] = { 9, 11, 0, 2, 4, 5, 7 };   // A-G
+
+    if (name.empty() || name[0] < 'A' || name[0] > 'G')
+        return false;
+
+    int root = letterPitchClasses[name[0] - 'A'];
+    size_t i = 1;
+    for (; i < name.size() && (name[i] == '#' || name[i] == 'b'); ++i)
+        root += name[i] == '#' ? 1 : -1;
+
+    std::string suffix = name.substr (i);
+    if (suffix == "maj" || suffix == "M")
+        suffix.clear();
+    else if (suffix == "min" || suffix == "-")
+        suffix = "m";
+
+    for (auto& q : qualities)
+    {
+        if (suffix != q.suffix)
+            continue;
+
+        rootPitchClass = (root % 12 + 12) % 12;
+        pitchClasses.clear();
+        for (int interval = 0; interval < 12; ++interval)
+            if ((q.intervals & (1 << interval)) != 0)
+                pitchClasses.push_back ((rootPitchClass + interval) % 12);
+        return true;
+    }
+
+    return false;
+}
+
+VoicingParams GuitarVoicer::withOfflineQuality (VoicingParams params)
+{
+    params.maxFret = NECK_FRETS;
+    params.searchRange = NECK_FRETS;
+    params.voiceLeading = true;
+    return params;
+}
+
+int GuitarVoicer::scoreVoiceLeading (const VoicingResult& from, const VoicingResult& to)
+{
+    int score = 0;
+    for (size_t s = 0; s < static_cast<size_t> (NUM_STRINGS); ++s)
+    {
+        int a = from.voicing[s].pitch;
+        int b = to.voicing[s].pitch;
+        if (a < 0 || b < 0)
+            continue;
+
+        if (a == b)
+            score += SCORE_COMMON_TONE;
+        else
+            score -= PENALTY_VOICE_MOTION * std::min (std::abs (a - b), 12);
+    }
+    return score;
+}
+
 int GuitarVoicer::scoreVoicing (const std::array<StringNote, NUM_STRINGS>& voicing,
                                 const std::vector<int>& pitchClasses,
                                 int rootPitchClass,
@@ -125,15 +244,50 @@ int GuitarVoicer::scoreVoicing (const std::array<StringNote, NUM_STRINGS>& voici
     return score;
 }
 
-std::string GuitarVoicer::makeCacheKey (const std::vector<int>& pitchClasses, int position,
-                                        const std::array<int, NUM_STRINGS>& openPitches)
+bool SharedVoicingCache::find (const std::string& key, VoicingResult& result) const
+{
+    const auto& shard = getShard (key);
+    std::shared_lock<std::shared_mutex> lock (shard.lock);
+
+    auto it = shard.map.find (key);
+    if (it == shard.map.end())
+        return false;
+
+    result = it->second;
+    return true;
+}
+
+void SharedVoicingCache::insert (const std::string& key, const VoicingResult& result)
+{
+    auto& shard = getShard (key);
+    std::unique_lock<std::shared_mutex> lock (shard.lock);
+    shard.map.emplace (key, result);
+}
+
+size_t SharedVoicingCache::size() const
+{
+    size_t total = 0;
+    for (const auto& shard : shards)
+    {
+        std::shared_lock<std::shared_mutex> lock (shard.lock);
+        total += shard.map.size();
+    }
+    return total;
+}
+
+std::string GuitarVoicer::makeCacheKey (const std::vector<int>& pitchClasses, int rootPitchClass,
+                                        int position, const VoicingParams& params)
 {
+    const auto& openPitches = params.openPitches;
+
     std::string key;
     for (size_t i = 0; i < pitchClasses.size(); ++i)
     {
         if (i > 0) key += ',';
         key += std::to_string (pitchClasses[i]);
     }
+    key += '/';
+    key += std::to_string (rootPitchClass);
     key += '@';
     key += std::to_string (position);
     // Include open pitches (encodes tuning + capo) so cache invalidates on change
@@ -143,6 +297,12 @@ std::string GuitarVoicer::makeCacheKey (const std::vector<int>& pitchClasses, in
         if (i > 0) key += ',';
         key += std::to_string (openPitches[i]);
     }
+    // ...and the search window and scoring options
+    key += '|';
+    key += std::to_string (params.fretSpan);
+    key += ',';
+    key += std::to_string (params.maxFret);
+    key += params.preferOpen ? ",o" : ",x";
     return key;
 }
 
@@ -151,10 +311,28 @@ VoicingResult GuitarVoicer::findBestVoicing (const std::vector<int>& pitchClasse
                                               int position,
                                               const VoicingParams& params)
 {
-    auto cacheKey = makeCacheKey (pitchClasses, position, params.openPitches);
-    auto it = voicingCache.find (cacheKey);
-    if (it != voicingCache.end())
-        return it->second;
+    auto cacheKey = makeCacheKey (pitchClasses, rootPitchClass, position, params);
+
+    if (sharedCache != nullptr)
+    {
+        VoicingResult cached;
+        if (sharedCache->find (cacheKey, cached))
+        {
+            ++stats.cacheHits;
+            return cached;
+        }
+    }
+    else
+    {
+        auto it = voicingCache.find (cacheKey);
+        if (it != voicingCache.end())
+        {
+            ++stats.cacheHits;
+            return it->second;
+        }
+    }
+
+    ++stats.cacheMisses;
 
     int lowFret = position;
     int highFret = std::min (position + params.fretSpan - 1, params.maxFret);
@@ -200,6 +378,11 @@ VoicingResult GuitarVoicer::findBestVoicing (const std::vector<int>& pitchClasse
     std::array<StringNote, NUM_STRINGS> bestVoicing {};
     bool found = false;
 
+    size_t nodes = 1;
+    for (auto& opts : candidates)
+        nodes *= opts.size();
+    stats.searchNodes += static_cast<uint32_t> (nodes);
+
     for (size_t i0 = 0; i0 < candidates[0].size(); ++i0)
     {
         for (size_t i1 = 0; i1 < candidates[1].size(); ++i1)
@@ -239,7 +422,10 @@ VoicingResult GuitarVoicer::findBestVoicing (const std::vector<int>& pitchClasse
         result.score = bestScore;
     }
 
-    voicingCache[cacheKey] = result;
+    if (sharedCache != nullptr)
+        sharedCache->insert (cacheKey, result);
+    else
+        voicingCache[cacheKey] = result;
     return result;
 }
 
@@ -248,15 +434,22 @@ VoicingResult GuitarVoicer::findBestPosition (const std::vector<int>& pitchClass
                                                const VoicingParams& params,
                                                int ccPositionOverride)
 {
+    ++stats.positionSearches;
+
     // CC override: use that exact position
     if (ccPositionOverride >= 0)
     {
         auto result = findBestVoicing (pitchClasses, rootPitchClass, ccPositionOverride, params);
         currentPosition = ccPositionOverride;
+        if (result.score > -10000)
+            previousVoicing = result;
         return result;
     }
 
-    int referencePos = params.initialPosition;
+    // With voice leading the hand stays near where it last played
+    bool leadFromPrevious = params.voiceLeading && previousVoicing.score > -10000;
+    int referencePos = (params.voiceLeading && currentPosition >= 0) ? currentPosition
+                                                                      : params.initialPosition;
 
     std::vector<int> positionsToTry = { 0 }; // always try open position
     int maxStartFret = params.maxFret - params.fretSpan + 1;
@@ -284,6 +477,8 @@ VoicingResult GuitarVoicer::findBestPosition (const std::vector<int>& pitchClass
             proximityBonus = 0;
 
         int combinedScore = result.score + proximityBonus;
+        if (leadFromPrevious)
+            combinedScore += scoreVoiceLeading (previousVoicing, result);
         if (combinedScore > bestCombinedScore)
         {
             bestCombinedScore = combinedScore;
@@ -293,5 +488,7 @@ VoicingResult GuitarVoicer::findBestPosition (const std::vector<int>& pitchClass
     }
 
     currentPosition = bestPos;
+    if (bestResult.score > -10000)
+        previousVoicing = bestResult;
     return bestResult;
 }
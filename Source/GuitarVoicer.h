@@ -1,9 +1,12 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <mutex>
+#include <shared_mutex>
 #include <cmath>
 #include <algorithm>
 
@@ -27,6 +30,31 @@ struct VoicingParams
     bool preferOpen    = true;
     int searchRange    = 5;
     int initialPosition = 0;
+    bool voiceLeading  = false;   // also score motion from the previous voicing
+};
+
+// Voicing cache that several GuitarVoicer instances on different threads
+// can share; lookups take a shared lock on one of a few independent shards
+class SharedVoicingCache
+{
+public:
+    bool find (const std::string& key, VoicingResult& result) const;
+    void insert (const std::string& key, const VoicingResult& result);
+    size_t size() const;
+
+private:
+    static constexpr size_t NUM_SHARDS = 16;
+
+    struct Shard
+    {
+        mutable std::shared_mutex lock;
+        std::unordered_map<std::string, VoicingResult> map;
+    };
+
+    std::array<Shard, NUM_SHARDS> shards;
+
+    const Shard& getShard (const std::string& key) const { return shards[std::hash<std::string>{} (key) % NUM_SHARDS]; }
+    Shard& getShard (const std::string& key) { return shards[std::hash<std::string>{} (key) % NUM_SHARDS]; }
 };
 
 class GuitarVoicer
@@ -49,14 +77,35 @@ public:
     static constexpr int SCORE_PROXIMITY         = 40;
     static constexpr int SCORE_SMALL_SPAN        = 30;
     static constexpr int SCORE_OPEN_STRING_BONUS = 20;
+    static constexpr int SCORE_COMMON_TONE       = 25;  // per string held over
+    static constexpr int PENALTY_VOICE_MOTION    = 3;   // per semitone a voice moves
+
+    static constexpr int NECK_FRETS = 15;
+
+    // Quality profile for offline rendering, where there is no deadline:
+    // the whole neck is searched and voice leading is scored
+    static VoicingParams withOfflineQuality (VoicingParams params);
 
     std::array<int, NUM_STRINGS> getStringOpenPitches (int tuningIndex, int capo) const;
 
+    // Chord symbol (e.g. "F#m7") for a set of pitch classes; writes into
+    // dest without allocating
+    static void getChordName (const std::vector<int>& pitchClasses, int rootPitchClass,
+                              char* dest, size_t destSize);
+
+    // Inverse of getChordName: "F#m7" → root 6, pitch classes { 6, 9, 1, 4 }
+    static bool parseChordName (const std::string& name, std::vector<int>& pitchClasses,
+                                int& rootPitchClass);
+
     int scoreVoicing (const std::array<StringNote, NUM_STRINGS>& voicing,
                       const std::vector<int>& pitchClasses,
                       int rootPitchClass,
                       bool preferOpen) const;
 
+    // Rewards strings that keep their pitch and penalises how far the
+    // other voices move between two consecutive voicings
+    static int scoreVoiceLeading (const VoicingResult& from, const VoicingResult& to);
+
     VoicingResult findBestVoicing (const std::vector<int>& pitchClasses,
                                    int rootPitchClass,
                                    int position,
@@ -67,15 +116,33 @@ public:
                                     const VoicingParams& params,
                                     int ccPositionOverride);
 
+    // Work counters, accumulated until resetStats()
+    struct Stats
+    {
+        uint32_t positionSearches = 0;
+        uint32_t cacheHits = 0;
+        uint32_t cacheMisses = 0;
+        uint32_t searchNodes = 0;
+    };
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = {}; }
+
     int getCurrentPosition() const { return currentPosition; }
     void setCurrentPosition (int pos) { currentPosition = pos; }
     void clearCache() { voicingCache.clear(); }
     void reset();
 
+    // Look up and store voicings in a cache shared with other voicers
+    // instead of this voicer's own (nullptr = use the private cache)
+    void setSharedCache (SharedVoicingCache* cache) { sharedCache = cache; }
+
 private:
     int currentPosition = -1;
+    VoicingResult previousVoicing;   // last chosen voicing, for voice leading
+    Stats stats;
     std::unordered_map<std::string, VoicingResult> voicingCache;
+    SharedVoicingCache* sharedCache = nullptr;
 
-    static std::string makeCacheKey (const std::vector<int>& pitchClasses, int position,
-                                     const std::array<int, NUM_STRINGS>& openPitches);
+    static std::string makeCacheKey (const std::vector<int>& pitchClasses, int rootPitchClass,
+                                     int position, const VoicingParams& params);
 };
@@ -0,0 +1,33 @@
+#include "MidiClipWriter.h"
+
+bool MidiClipWriter::write (juce::OutputStream& out,
+                            const std::vector<RenderedEvent>& events,
+                            double endBeat,
+                            int ticksPerQuarter,
+                            juce::MidiMessageSequence conductor)
+{
+    const double tpq = static_cast<double> (ticksPerQuarter);
+
+    juce::MidiFile file;
+    file.setTicksPerQuarterNote (ticksPerQuarter);
+
+    conductor.addEvent (juce::MidiMessage::endOfTrack(), endBeat * tpq);
+    file.addTrack (conductor);
+
+    juce::MidiMessageSequence track;
+    track.addEvent (juce::MidiMessage::textMetaEvent (3, "Guitar"), 0.0);
+    for (const auto& e : events)
+        track.addEvent (juce::MidiMessage (e.status, e.data1, e.data2, std::round (e.beat * tpq)));
+    track.addEvent (juce::MidiMessage::endOfTrack(), endBeat * tpq);
+    file.addTrack (track);
+
+    return file.writeTo (out);
+}
+
+juce::MidiMessageSequence MidiClipWriter::makeConductor (double bpm)
+{
+    juce::MidiMessageSequence conductor;
+    conductor.addEvent (juce::MidiMessage::tempoMetaEvent (juce::roundToInt (60000000.0 / std::max (bpm, 1.0))), 0.0);
+    conductor.addEvent (juce::MidiMessage::timeSignatureMetaEvent (4, 4), 0.0);
+    return conductor;
+}
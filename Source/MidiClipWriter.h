@@ -0,0 +1,19 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "OfflineRenderer.h"
+
+// Writes a rendered strum part as a standard MIDI file: a conductor track
+// holding the tempo/meter events, followed by the guitar track
+class MidiClipWriter
+{
+public:
+    static bool write (juce::OutputStream& out,
+                       const std::vector<RenderedEvent>& events,
+                       double endBeat,
+                       int ticksPerQuarter,
+                       juce::MidiMessageSequence conductor);
+
+    // Conductor track with a single tempo and 4/4 meter
+    static juce::MidiMessageSequence makeConductor (double bpm);
+};
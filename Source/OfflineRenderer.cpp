@@ -0,0 +1,246 @@
+#include "OfflineRenderer.h"
+
+namespace
+{
+    RenderedEvent makeNote (double beat, bool on, int channel, int pitch, int velocity, int slot)
+    {
+        return { beat,
+                 static_cast<uint8_t> ((on ? 0x90 : 0x80) | ((channel - 1) & 0x0f)),
+                 static_cast<uint8_t> (pitch & 0x7f),
+                 static_cast<uint8_t> (on ? (velocity & 0x7f) : 0),
+                 static_cast<int8_t> (slot) };
+    }
+}
+
+OfflineRenderer::OfflineRenderer (SharedVoicingCache* sharedCache)
+{
+    voicer.setSharedCache (sharedCache);
+}
+
+double OfflineRenderer::getTempoAt (const std::vector<TempoChange>& tempos, double beat)
+{
+    double bpm = 120.0;
+    for (const auto& t : tempos)
+    {
+        if (t.beat > beat)
+            break;
+        bpm = t.bpm;
+    }
+    return std::max (bpm, 1.0);
+}
+
+VoicingParams OfflineRenderer::makeVoicingParams (const StrumSettings& settings) const
+{
+    VoicingParams params;
+    params.openPitches = voicer.getStringOpenPitches (settings.tuningIndex, settings.capo);
+    params.fretSpan = settings.fretSpan;
+    params.maxFret = settings.maxFret;
+    params.preferOpen = settings.preferOpen;
+    params.searchRange = settings.searchRange;
+    params.initialPosition = settings.initialPosition;
+    if (settings.offlineQuality)
+        params = GuitarVoicer::withOfflineQuality (params);
+    return params;
+}
+
+VoicingPlanner::Chord OfflineRenderer::toPlannerChord (const std::vector<int>& notes)
+{
+    VoicingPlanner::Chord chord;
+    if (notes.empty())
+        return chord;
+
+    bool seen[12] = {};
+    for (auto pitch : notes)
+    {
+        int pc = pitch % 12;
+        if (! seen[pc])
+        {
+            seen[pc] = true;
+            chord.pitchClasses.push_back (pc);
+        }
+    }
+
+    chord.rootPitchClass = notes[0] % 12;
+    return chord;
+}
+
+std::vector<StringPitch> OfflineRenderer::toStringPitches (const VoicingResult& voicing)
+{
+    std::vector<StringPitch> result;
+    for (int s = 0; s < GuitarVoicer::NUM_STRINGS; ++s)
+        if (voicing.voicing[static_cast<size_t> (s)].pitch >= 0)
+            result.push_back ({ s, voicing.voicing[static_cast<size_t> (s)].pitch });
+    return result;
+}
+
+std::vector<StringPitch> OfflineRenderer::voiceChord (const std::vector<int>& notes,
+                                                      const StrumSettings& settings,
+                                                      const VoicingResult* planned)
+{
+    std::vector<StringPitch> result;
+
+    if (settings.voicingEnabled)
+    {
+        if (planned != nullptr && planned->score > -10000)
+            return toStringPitches (*planned);
+
+        auto chord = toPlannerChord (notes);
+        auto voicing = voicer.findBestPosition (chord.pitchClasses, chord.rootPitchClass,
+                                                makeVoicingParams (settings), -1);
+        if (voicing.score > -10000)
+            return toStringPitches (voicing);
+    }
+
+    // Voicing off (or no playable voicing): held notes take slots in order
+    for (size_t i = 0; i < notes.size() && i < static_cast<size_t> (StrumEngine::MAX_SLOTS); ++i)
+        result.push_back ({ static_cast<int> (i), notes[i] });
+    return result;
+}
+
+std::vector<RenderedEvent> OfflineRenderer::render (const StrumSettings& settings,
+                                                    const std::vector<ChordChange>& chords,
+                                                    const std::vector<TempoChange>& tempos,
+                                                    double endBeat)
+{
+    std::vector<RenderedEvent> events;
+
+    voicer.reset();
+    sequencer.reset();
+    strumEngine.clearActiveNotes();
+    sequencer.setPattern (settings.numSteps, settings.subdivisionIndex);
+    for (int i = 0; i < StepSequencer::MAX_STEPS; ++i)
+    {
+        sequencer.setStepVelocity (i, settings.stepVelocities[static_cast<size_t> (i)]);
+        sequencer.setStepDirection (i, settings.stepDirections[static_cast<size_t> (i)]);
+        sequencer.setStepLength (i, settings.stepLengths[static_cast<size_t> (i)]);
+    }
+    sequencer.setGroove (settings.groove, settings.grooveAmount);
+
+    // Strings of the previous strum that have yet to sound at `beat` are
+    // withdrawn, as the plugin drops its pending NoteOns.  Every earlier
+    // strum was cut off by the one after it, so only the events from the
+    // latest strum on can still lie ahead
+    size_t latestStrum = 0;
+    auto withdrawStrikesAfter = [this, &events, &latestStrum] (double beat)
+    {
+        strumEngine.withdrawStrikes (events, ~0u, beat, [] (const RenderedEvent& e) { return e.beat; },
+                                     latestStrum);
+    };
+
+    auto releaseAllAt = [this, &events, &withdrawStrikesAfter] (double beat)
+    {
+        withdrawStrikesAfter (beat);
+        strumEngine.releaseAll ([&events, beat] (int slot, const StrumEngine::ActiveNote& note)
+        {
+            events.push_back (makeNote (beat, false, note.channel, note.pitch, 0, slot));
+        });
+    };
+
+    // Offline quality: every chord is known, so voice the progression as a whole
+    std::vector<VoicingPlanner::Choice> planned;
+    if (settings.voicingEnabled && settings.offlineQuality)
+    {
+        std::vector<VoicingPlanner::Chord> progression;
+        progression.reserve (chords.size());
+        for (const auto& chord : chords)
+            progression.push_back (toPlannerChord (chord.notes));
+
+        planned = VoicingPlanner (voicer).plan (progression, makeVoicingParams (settings));
+    }
+
+    size_t nextChord = 0;
+    std::vector<StringPitch> voicing;
+
+    // Follows chord changes up to and including `beat`; letting go of every
+    // key silences the strum right away, as in the plugin
+    auto advanceChordsTo = [&] (double beat)
+    {
+        while (nextChord < chords.size() && chords[nextChord].beat <= beat + 1e-9)
+        {
+            auto index = nextChord++;
+            const auto& chord = chords[index];
+            if (chord.notes.empty())
+            {
+                voicing.clear();
+                releaseAllAt (chord.beat);
+            }
+            else
+            {
+                voicing = voiceChord (chord.notes, settings,
+                                      index < planned.size() ? &planned[index].voicing : nullptr);
+            }
+        }
+    };
+
+    // Walk the transport one beat at a time, just as host blocks would
+    for (double blockStart = 0.0; blockStart < endBeat; blockStart += 1.0)
+    {
+        auto blockEnd = std::min (blockStart + 1.0, endBeat);
+        auto steps = sequencer.processBlock (blockStart, blockEnd, true, false, 0.0, 0.0);
+
+        for (auto step : steps)
+        {
+            // A groove may pull the very first step ahead of the clip
+            step.beatPosition = std::max (0.0, step.beatPosition);
+
+            advanceChordsTo (step.beatPosition);
+
+            auto direction = step.direction;
+
+            if (direction == StepDirection::Rest || voicing.empty())
+            {
+                releaseAllAt (step.beatPosition);
+                continue;
+            }
+
+            if (step.velocity <= 0.0f)
+                continue;   // ghost step — let previous strum ring
+
+            withdrawStrikesAfter (step.beatPosition);
+
+            // Strings outside the voicing stop as the strum starts; the rest
+            // are choked as each one is struck again
+            strumEngine.releaseSlots (~StrumEngine::slotMaskFor (voicing),
+                [&events, &step] (int slot, const StrumEngine::ActiveNote& note)
+                {
+                    events.push_back (makeNote (step.beatPosition, false, note.channel, note.pitch, 0, slot));
+                });
+
+            auto strum = strumEngine.generateStrum (voicing, direction, step.velocity,
+                                                    settings.strumSpeedMs * step.strumSpeedScale, settings.humanize,
+                                                    settings.multiChannel,
+                                                    getTempoAt (tempos, step.beatPosition),
+                                                    step.beatPosition);
+
+            latestStrum = events.size();
+            for (const auto& note : strum)
+            {
+                auto beat = step.beatPosition + note.beatOffset;
+                if (note.chokePitch >= 0)
+                    events.push_back (makeNote (beat, false, note.chokeChannel, note.chokePitch, 0, note.slot));
+                events.push_back (makeNote (beat, true, note.channel, note.pitch, note.velocity, note.slot));
+            }
+        }
+    }
+
+    advanceChordsTo (endBeat);
+    releaseAllAt (endBeat);
+
+    // Strum notes may spill past the end; nothing starts there and
+    // everything stops at endBeat
+    events.erase (std::remove_if (events.begin(), events.end(),
+                      [endBeat] (const RenderedEvent& e) { return e.isNoteOn() && e.beat >= endBeat; }),
+                  events.end());
+    for (auto& e : events)
+        e.beat = std::min (e.beat, endBeat);
+
+    std::stable_sort (events.begin(), events.end(),
+        [] (const RenderedEvent& a, const RenderedEvent& b)
+        {
+            if (a.beat != b.beat)
+                return a.beat < b.beat;
+            return ! a.isNoteOn() && b.isNoteOn();
+        });
+
+    return events;
+}
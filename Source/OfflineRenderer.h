@@ -0,0 +1,100 @@
+#pragma once
+
+#include "GuitarVoicer.h"
+#include "StepSequencer.h"
+#include "StrumEngine.h"
+#include "VoicingPlanner.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Everything that shapes a rendered strum part — the offline equivalent of
+// the plugin's parameters
+struct StrumSettings
+{
+    int subdivisionIndex = 0;   // index into StepSequencer::SUBDIVISION_BEATS
+    int numSteps = StepSequencer::DEFAULT_STEPS;
+    std::array<float, StepSequencer::MAX_STEPS> stepVelocities = StepSequencer::DEFAULT_STEP_VELOCITIES;
+    std::array<StepDirection, StepSequencer::MAX_STEPS> stepDirections {};
+    std::array<float, StepSequencer::MAX_STEPS> stepLengths {};   // in grid steps
+
+    float strumSpeedMs = 8.0f;
+    float humanize = 0.5f;      // 0-1
+    GrooveTemplate groove;      // straight unless set
+    float grooveAmount = 1.0f;  // 0-1
+    bool voicingEnabled = true;
+    bool multiChannel = false;
+
+    int tuningIndex = 0;
+    int capo = 0;
+    int fretSpan = 4;
+    int maxFret = 12;
+    bool preferOpen = true;
+    int searchRange = 5;
+    int initialPosition = 0;
+    bool offlineQuality = false;   // GuitarVoicer::withOfflineQuality search, with
+                                   // the whole progression planned by VoicingPlanner
+
+    StrumSettings()
+    {
+        // Alternating Down/Up, as in the plugin
+        for (size_t i = 0; i < stepDirections.size(); ++i)
+            stepDirections[i] = (i % 2 == 0) ? StepDirection::Down : StepDirection::Up;
+
+        stepLengths.fill (1.0f);
+    }
+};
+
+// Chord held from `beat` until the next change (empty = nothing held)
+struct ChordChange
+{
+    double beat;
+    std::vector<int> notes;   // MIDI notes, ascending
+};
+
+struct TempoChange
+{
+    double beat;
+    double bpm;
+};
+
+struct RenderedEvent
+{
+    double beat;
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+    int8_t slot;   // string/voice slot the note belongs to
+
+    bool isNoteOn() const { return (status & 0xf0) == 0x90 && data2 > 0; }
+};
+
+// Runs the sequencer → voicer → strum pipeline over a whole chord timeline
+// at once, without a transport or real-time constraints.  One renderer per
+// thread; voicings can be shared between renderers through a
+// SharedVoicingCache.
+class OfflineRenderer
+{
+public:
+    explicit OfflineRenderer (SharedVoicingCache* sharedCache = nullptr);
+
+    // Strummed note events in [0, endBeat), sorted by beat with note-offs
+    // ahead of note-ons at the same beat.  chords and tempos must be sorted
+    // by beat; an empty tempo map means 120 BPM.
+    std::vector<RenderedEvent> render (const StrumSettings& settings,
+                                       const std::vector<ChordChange>& chords,
+                                       const std::vector<TempoChange>& tempos,
+                                       double endBeat);
+
+private:
+    GuitarVoicer voicer;
+    StepSequencer sequencer;
+    StrumEngine strumEngine;
+
+    VoicingParams makeVoicingParams (const StrumSettings& settings) const;
+    static VoicingPlanner::Chord toPlannerChord (const std::vector<int>& notes);
+    static std::vector<StringPitch> toStringPitches (const VoicingResult& voicing);
+    std::vector<StringPitch> voiceChord (const std::vector<int>& notes, const StrumSettings& settings,
+                                         const VoicingResult* planned);
+    static double getTempoAt (const std::vector<TempoChange>& tempos, double beat);
+};
@@ -4,19 +4,54 @@ GuitarStrumSequencerEditor::GuitarStrumSequencerEditor (GuitarStrumSequencerProc
     : AudioProcessorEditor (p),
       processorRef (p),
       stepSequencerComp (p.getAPVTS(), p.currentStepForUI),
-      controlPanelComp (p.getAPVTS(), p)
+      controlPanelComp (p.getAPVTS(), p),
+      diagnosticsComp (p),
+      exportComp (p),
+      songComp (p.getSongMode()),
+      vblankAttachment (this, [this] { refreshComponents(); })
 {
     setLookAndFeel (&customLookAndFeel);
     setSize (700, 500);
 
     // Subdivision selector in header
-    subdivisionBox.addItemList ({ "8th Notes", "16th Notes" }, 1);
+    subdivisionBox.addItemList ({ "8th Notes", "16th Notes", "8th Triplets", "16th Triplets",
+                                  "Dotted 8th", "Dotted 16th" }, 1);
     addAndMakeVisible (subdivisionBox);
     subdivisionAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
         p.getAPVTS(), "subdivision", subdivisionBox);
 
+    // Pattern length: drag or type 1-64
+    patternLengthSlider.setSliderStyle (juce::Slider::LinearBar);
+    patternLengthSlider.setTextValueSuffix (" steps");
+    addAndMakeVisible (patternLengthSlider);
+    patternLengthAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        p.getAPVTS(), "patternLength", patternLengthSlider);
+
     addAndMakeVisible (stepSequencerComp);
     addAndMakeVisible (controlPanelComp);
+    exportButton.setClickingTogglesState (true);
+    exportButton.onClick = [this]
+    {
+        diagnosticsComp.setVisible (false);
+        songButton.setToggleState (false, juce::dontSendNotification);
+        songComp.setVisible (false);
+        exportComp.setVisible (exportButton.getToggleState());
+    };
+    addAndMakeVisible (exportButton);
+
+    songButton.setClickingTogglesState (true);
+    songButton.onClick = [this]
+    {
+        diagnosticsComp.setVisible (false);
+        exportButton.setToggleState (false, juce::dontSendNotification);
+        exportComp.setVisible (false);
+        songComp.setVisible (songButton.getToggleState());
+    };
+    addAndMakeVisible (songButton);
+
+    addChildComponent (diagnosticsComp);
+    addChildComponent (exportComp);
+    addChildComponent (songComp);
 }
 
 GuitarStrumSequencerEditor::~GuitarStrumSequencerEditor()
@@ -24,6 +59,26 @@ GuitarStrumSequencerEditor::~GuitarStrumSequencerEditor()
     setLookAndFeel (nullptr);
 }
 
+void GuitarStrumSequencerEditor::refreshComponents()
+{
+    stepSequencerComp.refresh();
+    controlPanelComp.refresh();
+    diagnosticsComp.refresh();
+    exportComp.refresh();
+}
+
+void GuitarStrumSequencerEditor::mouseDoubleClick (const juce::MouseEvent& event)
+{
+    if (event.y < 40)
+    {
+        exportButton.setToggleState (false, juce::dontSendNotification);
+        exportComp.setVisible (false);
+        songButton.setToggleState (false, juce::dontSendNotification);
+        songComp.setVisible (false);
+        diagnosticsComp.setVisible (! diagnosticsComp.isVisible());
+    }
+}
+
 void GuitarStrumSequencerEditor::paint (juce::Graphics& g)
 {
     g.fillAll (CustomLookAndFeel::bgDark);
@@ -51,10 +106,18 @@ void GuitarStrumSequencerEditor::resized()
     // Header
     auto header = bounds.removeFromTop (40);
     subdivisionBox.setBounds (header.removeFromRight (140).reduced (10, 6));
+    patternLengthSlider.setBounds (header.removeFromRight (80).reduced (0, 8));
+    header.removeFromRight (8);
+    exportButton.setBounds (header.removeFromRight (70).reduced (0, 6));
+    header.removeFromRight (6);
+    songButton.setBounds (header.removeFromRight (60).reduced (0, 6));
 
     // Step sequencer area
     auto seqArea = bounds.removeFromTop (220);
     stepSequencerComp.setBounds (seqArea);
+    diagnosticsComp.setBounds (seqArea);
+    exportComp.setBounds (seqArea);
+    songComp.setBounds (seqArea);
 
     // Control panel takes the rest
     controlPanelComp.setBounds (bounds);
@@ -5,6 +5,9 @@
 #include "UI/CustomLookAndFeel.h"
 #include "UI/StepSequencerComponent.h"
 #include "UI/ControlPanelComponent.h"
+#include "UI/DiagnosticsComponent.h"
+#include "UI/ExportComponent.h"
+#include "UI/SongComponent.h"
 
 class GuitarStrumSequencerEditor : public juce::AudioProcessorEditor
 {
@@ -14,6 +17,10 @@ public:
 
     void paint (juce::Graphics& g) override;
     void resized() override;
+    void mouseDoubleClick (const juce::MouseEvent& event) override;
+
+    // Pulls the latest playing state into the live-updating components
+    void refreshComponents();
 
 private:
     GuitarStrumSequencerProcessor& processorRef;
@@ -21,11 +28,27 @@ private:
 
     // Header
     juce::ComboBox subdivisionBox;
+    juce::Slider patternLengthSlider;
+    juce::TextButton exportButton { "Export" };
+    juce::TextButton songButton { "Song" };
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> subdivisionAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> patternLengthAttach;
 
     // Sections
     StepSequencerComponent stepSequencerComp;
     ControlPanelComponent controlPanelComp;
 
+    // Overlays the step sequencer; double-click the header to toggle
+    DiagnosticsComponent diagnosticsComp;
+
+    // Overlays the step sequencer; toggled by the header's Export button
+    ExportComponent exportComp;
+
+    // Overlays the step sequencer; toggled by the header's Song button
+    SongComponent songComp;
+
+    // One display-synced callback drives every live-updating component
+    juce::VBlankAttachment vblankAttachment;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GuitarStrumSequencerEditor)
 };
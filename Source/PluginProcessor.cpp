@@ -5,6 +5,15 @@ GuitarStrumSequencerProcessor::GuitarStrumSequencerProcessor()
     : AudioProcessor (BusesProperties()),
       apvts (*this, nullptr, "Parameters", createParameterLayout())
 {
+    for (int i = 0; i < StepSequencer::MAX_STEPS; ++i)
+    {
+        stepVelocityParams[static_cast<size_t> (i)] = apvts.getRawParameterValue ("step" + juce::String (i + 1));
+        stepDirectionParams[static_cast<size_t> (i)] = apvts.getRawParameterValue ("dir" + juce::String (i + 1));
+    }
+    subdivisionParam = apvts.getRawParameterValue ("subdivision");
+    patternLengthParam = apvts.getRawParameterValue ("patternLength");
+    grooveParam = apvts.getRawParameterValue ("groove");
+    grooveAmountParam = apvts.getRawParameterValue ("grooveAmount");
 }
 
 GuitarStrumSequencerProcessor::~GuitarStrumSequencerProcessor() = default;
@@ -15,7 +24,12 @@ juce::AudioProcessorValueTreeState::ParameterLayout GuitarStrumSequencerProcesso
 
     params.push_back (std::make_unique<juce::AudioParameterChoice> (
         juce::ParameterID { "subdivision", 1 }, "Subdivision",
-        juce::StringArray { "8th Notes", "16th Notes" }, 0));
+        juce::StringArray { "8th Notes", "16th Notes", "8th Triplets", "16th Triplets",
+                            "Dotted 8th", "Dotted 16th" }, 0));
+
+    params.push_back (std::make_unique<juce::AudioParameterInt> (
+        juce::ParameterID { "patternLength", 1 }, "Pattern Length",
+        1, StepSequencer::MAX_STEPS, StepSequencer::DEFAULT_STEPS));
 
     params.push_back (std::make_unique<juce::AudioParameterFloat> (
         juce::ParameterID { "strumSpeed", 1 }, "Strum Speed",
@@ -25,6 +39,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout GuitarStrumSequencerProcesso
         juce::ParameterID { "humanize", 1 }, "Humanize",
         juce::NormalisableRange<float> (0.0f, 100.0f, 1.0f), 50.0f));
 
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        juce::ParameterID { "groove", 1 }, "Groove",
+        juce::StringArray { "Off", "Swing", "Laid Back", "Push", "File" }, 0));
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat> (
+        juce::ParameterID { "grooveAmount", 1 }, "Groove Amount",
+        juce::NormalisableRange<float> (0.0f, 100.0f, 1.0f), 100.0f));
+
     params.push_back (std::make_unique<juce::AudioParameterBool> (
         juce::ParameterID { "guitarVoicing", 1 }, "Guitar Voicing", true));
 
@@ -57,22 +79,18 @@ juce::AudioProcessorValueTreeState::ParameterLayout GuitarStrumSequencerProcesso
     params.push_back (std::make_unique<juce::AudioParameterBool> (
         juce::ParameterID { "multiChannel", 1 }, "Multi-Channel", false));
 
-    // Step velocities 1-16 (default: repeating High/Medium/Low pattern)
-    const float defaultStepVelocities[StepSequencer::STEP_COUNT] = {
-        107, 0, 90, 90, 0, 90, 100, 90,
-        107, 0, 90, 90, 0, 90, 100, 90
-    };
-    for (int i = 0; i < StepSequencer::STEP_COUNT; ++i)
+    // Step velocities 1-64 (default: repeating High/Medium/Low pattern)
+    for (int i = 0; i < StepSequencer::MAX_STEPS; ++i)
     {
         auto id = "step" + juce::String (i + 1);
         auto name = "Step " + juce::String (i + 1);
         params.push_back (std::make_unique<juce::AudioParameterFloat> (
             juce::ParameterID { id, 1 }, name,
-            juce::NormalisableRange<float> (0.0f, 127.0f, 1.0f), defaultStepVelocities[i]));
+            juce::NormalisableRange<float> (0.0f, 127.0f, 1.0f), StepSequencer::DEFAULT_STEP_VELOCITIES[static_cast<size_t> (i)]));
     }
 
-    // Step directions 1-16 (default: alternating Down/Up)
-    for (int i = 0; i < StepSequencer::STEP_COUNT; ++i)
+    // Step directions 1-64 (default: alternating Down/Up)
+    for (int i = 0; i < StepSequencer::MAX_STEPS; ++i)
     {
         auto id = "dir" + juce::String (i + 1);
         auto name = "Dir " + juce::String (i + 1);
@@ -88,6 +106,8 @@ juce::AudioProcessorValueTreeState::ParameterLayout GuitarStrumSequencerProcesso
 void GuitarStrumSequencerProcessor::prepareToPlay (double sampleRate, int /*samplesPerBlock*/)
 {
     currentSampleRate = sampleRate;
+    samplesProcessed = 0;
+    blackBox.prepare (sampleRate, isNonRealtime());
     sequencer.reset();
     strumEngine.clearActiveNotes();
     heldNotes.clear();
@@ -100,21 +120,68 @@ void GuitarStrumSequencerProcessor::prepareToPlay (double sampleRate, int /*samp
     lastStepIndex = 0;
     lastStepDirection = StepDirection::Down;
     lastStepVelocity = 0.0f;
+    lastStepStrumSpeedScale = 1.0f;
     lastStepBeat = -1.0;
+    nextBlockBeat = -1.0;
     voicer.reset();
     pendingEvents.clear();
-    voicingForUIValid = false;
+    pendingEvents.reserve (PENDING_EVENT_CAPACITY);
+    isIdle = false;
 
-    // Sync step velocities from parameters
-    for (int i = 0; i < StepSequencer::STEP_COUNT; ++i)
+    auto telemetryVersion = telemetryState.version;
+    telemetryState = {};
+    telemetryState.version = telemetryVersion;
+    telemetryDirty = true;
+    publishTelemetry();
+
+    syncPattern();
+}
+
+void GuitarStrumSequencerProcessor::releaseResources() {}
+
+void GuitarStrumSequencerProcessor::syncPattern()
+{
+    int numSteps = static_cast<int> (patternLengthParam->load());
+    sequencer.setPattern (numSteps, static_cast<int> (subdivisionParam->load()));
+
+    for (int i = 0; i < numSteps; ++i)
     {
-        auto* param = apvts.getRawParameterValue ("step" + juce::String (i + 1));
-        if (param != nullptr)
-            sequencer.setStepVelocity (i, param->load());
+        sequencer.setStepVelocity (i, stepVelocityParams[static_cast<size_t> (i)]->load());
+        sequencer.setStepDirection (i, static_cast<StepDirection> (
+            static_cast<int> (stepDirectionParams[static_cast<size_t> (i)]->load())));
     }
+
+    sequencer.setArrangement (songMode.acquire());
+
+    GrooveTemplate loaded;
+    while (grooveFifo.pop (loaded))
+        audioFileGroove = loaded;
+
+    sequencer.setGroove (selectGroove (audioFileGroove), grooveAmountParam->load() / 100.0f);
 }
 
-void GuitarStrumSequencerProcessor::releaseResources() {}
+const GrooveTemplate& GuitarStrumSequencerProcessor::selectGroove (const GrooveTemplate& fromFile) const
+{
+    int index = static_cast<int> (grooveParam->load());
+    return index < GrooveTemplate::NUM_PRESETS ? GrooveTemplate::getPreset (index) : fromFile;
+}
+
+bool GuitarStrumSequencerProcessor::loadGrooveFile (const juce::File& file, juce::String& error)
+{
+    GrooveTemplate groove;
+    double grid = StepSequencer::SUBDIVISION_BEATS[static_cast<size_t> (subdivisionParam->load())];
+    if (! GrooveFile::load (file, grid, groove, error))
+        return false;
+
+    fileGroove = groove;
+    apvts.state.setProperty ("grooveFile", GrooveFile::toJson (groove), nullptr);
+    grooveFifo.push (groove);
+
+    if (auto* param = apvts.getParameter ("groove"))
+        param->setValueNotifyingHost (param->convertTo0to1 (static_cast<float> (GrooveTemplate::NUM_PRESETS)));
+
+    return true;
+}
 
 bool GuitarStrumSequencerProcessor::isBusesLayoutSupported (const BusesLayout&) const
 {
@@ -142,6 +209,36 @@ void GuitarStrumSequencerProcessor::removeFromArray (std::vector<int>& arr, int
         arr.erase (it);
 }
 
+StrumSettings GuitarStrumSequencerProcessor::getStrumSettings()
+{
+    StrumSettings settings;
+    settings.subdivisionIndex = static_cast<int> (subdivisionParam->load());
+    settings.numSteps = static_cast<int> (patternLengthParam->load());
+
+    for (size_t i = 0; i < static_cast<size_t> (StepSequencer::MAX_STEPS); ++i)
+    {
+        settings.stepVelocities[i] = stepVelocityParams[i]->load();
+        settings.stepDirections[i] = static_cast<StepDirection> (static_cast<int> (stepDirectionParams[i]->load()));
+    }
+
+    settings.strumSpeedMs = apvts.getRawParameterValue ("strumSpeed")->load();
+    settings.humanize = apvts.getRawParameterValue ("humanize")->load() / 100.0f;
+    settings.groove = selectGroove (fileGroove);
+    settings.grooveAmount = grooveAmountParam->load() / 100.0f;
+    settings.voicingEnabled = apvts.getRawParameterValue ("guitarVoicing")->load() >= 0.5f;
+    settings.multiChannel = settings.voicingEnabled
+        && apvts.getRawParameterValue ("multiChannel")->load() >= 0.5f;
+
+    settings.tuningIndex = static_cast<int> (apvts.getRawParameterValue ("tuning")->load());
+    settings.capo = static_cast<int> (apvts.getRawParameterValue ("capo")->load());
+    settings.fretSpan = static_cast<int> (apvts.getRawParameterValue ("fretSpan")->load());
+    settings.maxFret = static_cast<int> (apvts.getRawParameterValue ("maxFret")->load());
+    settings.preferOpen = apvts.getRawParameterValue ("preferOpenStrings")->load() >= 0.5f;
+    settings.searchRange = static_cast<int> (apvts.getRawParameterValue ("searchRange")->load());
+    settings.initialPosition = static_cast<int> (apvts.getRawParameterValue ("initialPosition")->load());
+    return settings;
+}
+
 VoicingParams GuitarStrumSequencerProcessor::readVoicingParams()
 {
     VoicingParams params;
@@ -153,15 +250,23 @@ VoicingParams GuitarStrumSequencerProcessor::readVoicingParams()
     params.preferOpen = apvts.getRawParameterValue ("preferOpenStrings")->load() >= 0.5f;
     params.searchRange = static_cast<int> (apvts.getRawParameterValue ("searchRange")->load());
     params.initialPosition = static_cast<int> (apvts.getRawParameterValue ("initialPosition")->load());
+
+    // Bouncing has no deadline: search the whole neck and lead the voices
+    if (isNonRealtime())
+        return GuitarVoicer::withOfflineQuality (params);
+
     return params;
 }
 
 void GuitarStrumSequencerProcessor::updateVoicedNotes()
 {
+    TraceRecorder::Scope traceScope (tracer, TraceMarker::UpdateVoicedNotes);
+
     if (heldNotes.empty())
     {
         voicedNotes.clear();
-        voicingForUIValid = false;
+        telemetryState.voicingValid = false;
+        telemetryDirty = true;
         return;
     }
 
@@ -181,21 +286,30 @@ void GuitarStrumSequencerProcessor::updateVoicedNotes()
     int rootPitchClass = heldNotes[0] % 12;
     auto params = readVoicingParams();
 
-    auto result = voicer.findBestPosition (pitchClasses, rootPitchClass, params, ccPositionOverride);
+    auto result = [&]
+    {
+        TraceRecorder::Scope searchScope (tracer, TraceMarker::FindBestPosition);
+        return voicer.findBestPosition (pitchClasses, rootPitchClass, params, ccPositionOverride);
+    }();
 
     if (result.score > -10000)
     {
-        std::vector<int> pitches;
+        voicedNotes.clear();
         for (int s = 0; s < GuitarVoicer::NUM_STRINGS; ++s)
         {
             if (result.voicing[static_cast<size_t> (s)].pitch >= 0)
-                pitches.push_back (result.voicing[static_cast<size_t> (s)].pitch);
+                voicedNotes.push_back ({ s, result.voicing[static_cast<size_t> (s)].pitch });
         }
-        std::sort (pitches.begin(), pitches.end());
-        voicedNotes = pitches;
 
-        currentVoicingForUI = result;
-        voicingForUIValid = true;
+        // Input MIDI is read before the play head, so this is the beat the
+        // block starts at if the transport ran on
+        tracer.instant (TraceMarker::ChordChange, nextBlockBeat, heldNotes[0]);
+
+        telemetryState.voicing = result;
+        telemetryState.voicingValid = true;
+        GuitarVoicer::getChordName (pitchClasses, rootPitchClass,
+                                    telemetryState.chordName.data(), telemetryState.chordName.size());
+        telemetryDirty = true;
 
         if (ccPositionUsed)
         {
@@ -205,58 +319,110 @@ void GuitarStrumSequencerProcessor::updateVoicedNotes()
     }
     else
     {
-        voicedNotes = heldNotes;
+        voicedNotes.clear();
+        for (size_t i = 0; i < heldNotes.size(); ++i)
+            voicedNotes.push_back ({ static_cast<int> (i), heldNotes[i] });
     }
 }
 
-std::vector<int> GuitarStrumSequencerProcessor::getNotesToStrum()
+std::vector<StringPitch> GuitarStrumSequencerProcessor::getNotesToStrum()
 {
     if (apvts.getRawParameterValue ("guitarVoicing")->load() >= 0.5f)
         return voicedNotes;
-    return heldNotes;
+
+    // Voicing off: held keys take voice slots in ascending pitch order
+    std::vector<StringPitch> notes;
+    for (size_t i = 0; i < heldNotes.size(); ++i)
+        notes.push_back ({ static_cast<int> (i), heldNotes[i] });
+    return notes;
 }
 
-// ── Beat-based pending event scheduling ──────────────────────────────
+// ── Tick-based pending event scheduling ──────────────────────────────
 
-void GuitarStrumSequencerProcessor::scheduleEvent (const juce::MidiMessage& msg, double beatPos)
+juce::int64 GuitarStrumSequencerProcessor::beatToTick (double beat)
 {
-    pendingEvents.push_back ({ msg, beatPos });
+    return static_cast<juce::int64> (std::llround (beat * static_cast<double> (TICKS_PER_BEAT)));
+}
+
+void GuitarStrumSequencerProcessor::scheduleNoteOn (int channel, int pitch, int velocity,
+                                                      int slot, juce::int64 tick)
+{
+    pendingEvents.push_back ({ tick,
+                               static_cast<juce::uint8> (0x90 | ((channel - 1) & 0x0f)),
+                               static_cast<juce::uint8> (pitch & 0x7f),
+                               static_cast<juce::uint8> (velocity & 0x7f),
+                               static_cast<juce::int8> (slot),
+                               static_cast<juce::uint8> (PriorityNoteOn) });
+}
+
+void GuitarStrumSequencerProcessor::scheduleNoteOff (int channel, int pitch, int slot, juce::int64 tick)
+{
+    pendingEvents.push_back ({ tick,
+                               static_cast<juce::uint8> (0x80 | ((channel - 1) & 0x0f)),
+                               static_cast<juce::uint8> (pitch & 0x7f),
+                               0,
+                               static_cast<juce::int8> (slot),
+                               static_cast<juce::uint8> (PriorityNoteOff) });
 }
 
 void GuitarStrumSequencerProcessor::emitPendingEvents (juce::MidiBuffer& buffer,
-                                                         double blockStartBeat,
-                                                         double blockEndBeat,
-                                                         double beatsPerSample,
+                                                         juce::int64 blockStartTick,
+                                                         juce::int64 blockEndTick,
+                                                         double ticksPerSample,
                                                          int numSamples)
 {
-    // Sort by beat position so NoteOffs (scheduled slightly earlier) come before NoteOns
+    TraceRecorder::Scope traceScope (tracer, TraceMarker::EmitPendingEvents,
+                                     static_cast<double> (blockStartTick) / static_cast<double> (TICKS_PER_BEAT),
+                                     static_cast<int> (pendingEvents.size()));
+
+    // Sort by tick, then priority so NoteOffs come before NoteOns at the same tick
     std::sort (pendingEvents.begin(), pendingEvents.end(),
         [] (const PendingMidiEvent& a, const PendingMidiEvent& b)
         {
-            return a.beatPosition < b.beatPosition;
+            if (a.tick != b.tick)
+                return a.tick < b.tick;
+            return a.priority < b.priority;
         });
 
     auto it = pendingEvents.begin();
     while (it != pendingEvents.end())
     {
-        if (it->beatPosition < blockStartBeat - 0.1)
+        if (it->tick < blockStartTick - LATE_EVENT_TICKS)
         {
             // Stale event (e.g. from before a cycle wrap) — drop silently
+            ++blockStats.droppedEvents;
             it = pendingEvents.erase (it);
         }
-        else if (it->beatPosition < blockStartBeat)
+        else if (it->tick < blockStartTick)
         {
             // Slightly past event (cross-buffer strum note) — emit at start of block
-            buffer.addEvent (it->message, 0);
+            const juce::uint8 bytes[] = { it->status, it->data1, it->data2 };
+            buffer.addEvent (bytes, 3, 0);
+            ++blockStats.eventsEmitted;
+            ++blockStats.lateEvents;
+            recordTimingError (static_cast<double> (blockStartTick - it->tick) / ticksPerSample);
+
+            if (it->isNoteOn() && it->slot >= 0 && it->slot < GuitarVoicer::NUM_STRINGS)
+                strikeFifo.push ({ samplesProcessed, static_cast<uint8_t> (it->slot), it->data2 });
             it = pendingEvents.erase (it);
         }
-        else if (it->beatPosition < blockEndBeat)
+        else if (it->tick < blockEndTick)
         {
             // Within this block — calculate exact sample position
-            double beatOffset = it->beatPosition - blockStartBeat;
-            int samplePos = static_cast<int> (std::round (beatOffset / beatsPerSample));
+            auto tickOffset = static_cast<double> (it->tick - blockStartTick);
+            double idealPos = tickOffset / ticksPerSample;
+            int samplePos = static_cast<int> (std::round (idealPos));
+            if (samplePos > numSamples - 1)
+                ++blockStats.clampedEvents;
             samplePos = std::max (0, std::min (samplePos, numSamples - 1));
-            buffer.addEvent (it->message, samplePos);
+            const juce::uint8 bytes[] = { it->status, it->data1, it->data2 };
+            buffer.addEvent (bytes, 3, samplePos);
+            ++blockStats.eventsEmitted;
+            recordTimingError (samplePos - idealPos);
+
+            if (it->isNoteOn() && it->slot >= 0 && it->slot < GuitarVoicer::NUM_STRINGS)
+                strikeFifo.push ({ samplesProcessed + samplePos,
+                                   static_cast<uint8_t> (it->slot), it->data2 });
             it = pendingEvents.erase (it);
         }
         else
@@ -267,31 +433,218 @@ void GuitarStrumSequencerProcessor::emitPendingEvents (juce::MidiBuffer& buffer,
     }
 }
 
-void GuitarStrumSequencerProcessor::killActiveNotesAt (double beatPos)
+void GuitarStrumSequencerProcessor::recordTimingError (double errorSamples)
+{
+    auto absError = std::abs (errorSamples);
+    ++blockStats.timingErrorHistogram[static_cast<size_t> (getTimingErrorBin (absError))];
+    blockStats.maxTimingError = std::max (blockStats.maxTimingError, static_cast<float> (absError));
+}
+
+void GuitarStrumSequencerProcessor::killActiveNotesAt (juce::int64 tick)
 {
-    for (auto& note : strumEngine.getActiveNotes())
+    strumEngine.releaseAll ([this, tick] (int slot, const StrumEngine::ActiveNote& note)
     {
-        scheduleEvent (juce::MidiMessage::noteOff (note.channel, note.pitch, (juce::uint8) 0),
-                       beatPos);
+        scheduleNoteOff (note.channel, note.pitch, slot, tick);
+    });
+}
+
+void GuitarStrumSequencerProcessor::dropPendingStrikes (uint32_t slotMask)
+{
+    // Everything still pending has yet to sound, however late it is
+    strumEngine.withdrawStrikes (pendingEvents, slotMask, std::numeric_limits<juce::int64>::min(),
+                                 [] (const PendingMidiEvent& e) { return e.tick; });
+}
+
+void GuitarStrumSequencerProcessor::scheduleStrum (const std::vector<StringPitch>& voicing,
+                                                     const std::vector<StringPitch>& strikes,
+                                                     StepDirection direction,
+                                                     float velocity,
+                                                     float strumSpeed,
+                                                     float humanize,
+                                                     bool multiChannel,
+                                                     double bpm,
+                                                     juce::int64 strumTick)
+{
+    // Strings that are not part of the voicing are silenced as the strum starts
+    strumEngine.releaseSlots (~StrumEngine::slotMaskFor (voicing),
+        [this, strumTick] (int slot, const StrumEngine::ActiveNote& note)
+        {
+            scheduleNoteOff (note.channel, note.pitch, slot, strumTick);
+        });
+
+    auto strumNotes = strumEngine.generateStrum (strikes, direction, velocity,
+                                                 strumSpeed, humanize, multiChannel, bpm,
+                                                 static_cast<double> (strumTick) / static_cast<double> (TICKS_PER_BEAT));
+
+    // Each re-struck string is choked at the exact tick it is struck again
+    for (auto& sn : strumNotes)
+    {
+        auto noteTick = strumTick + beatToTick (sn.beatOffset);
+
+        if (sn.chokePitch >= 0)
+            scheduleNoteOff (sn.chokeChannel, sn.chokePitch, sn.slot, noteTick);
+
+        scheduleNoteOn (sn.channel, sn.pitch, sn.velocity, sn.slot, noteTick);
     }
-    strumEngine.clearActiveNotes();
+}
+
+// ── Idle fast path ───────────────────────────────────────────────────
+
+bool GuitarStrumSequencerProcessor::needsFullProcessing (const juce::MidiBuffer& midi)
+{
+    // Notes and controllers can change held/voicing state; anything else
+    // is passed through untouched by the full path too
+    for (const auto metadata : midi)
+    {
+        if (metadata.numBytes <= 0)
+            continue;
+
+        auto type = metadata.data[0] & 0xf0;
+        if (type == 0x80 || type == 0x90 || type == 0xb0)
+            return true;
+    }
+    return false;
+}
+
+void GuitarStrumSequencerProcessor::processIdleBlock()
+{
+    // Only follow the transport so the step display keeps moving
+    bool isPlaying = false;
+    double ppqPosition = 0.0;
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto posInfo = playHead->getPosition())
+        {
+            isPlaying = posInfo->getIsPlaying();
+            if (auto p = posInfo->getPpqPosition())
+                ppqPosition = *p;
+        }
+    }
+
+    if (isPlaying)
+    {
+        sequencer.setPattern (static_cast<int> (patternLengthParam->load()),
+                              static_cast<int> (subdivisionParam->load()));
+        sequencer.setArrangement (songMode.acquire());
+
+        // Keep the step the transport is in as the last one played, as if
+        // it had fired with nothing held, so a chord arriving late in that
+        // step still re-triggers straight away when we wake up
+        auto step = sequencer.getStepAt (ppqPosition);
+        currentStepForUI.store (step.stepIndex);
+        lastStepIndex = step.stepIndex;
+        lastStepDirection = step.direction;
+        lastStepBeat = step.beatPosition;
+        lastStepVelocity = step.velocity;
+        lastStepStrumSpeedScale = step.strumSpeedScale;
+    }
+    else
+    {
+        if (wasPlaying)
+            currentStepForUI.store (-1);
+        lastStepBeat = -1.0;
+    }
+
+    wasPlaying = isPlaying;
+}
+
+// ── UI telemetry ─────────────────────────────────────────────────────
+
+void GuitarStrumSequencerProcessor::publishTelemetry()
+{
+    int step = currentStepForUI.load (std::memory_order_relaxed);
+    auto activeStrings = strumEngine.getActiveMask();
+    int position = voicer.getCurrentPosition();
+
+    if (step != telemetryState.step || activeStrings != telemetryState.activeStrings
+        || position != telemetryState.position)
+    {
+        telemetryState.step = step;
+        telemetryState.activeStrings = activeStrings;
+        telemetryState.position = position;
+        telemetryDirty = true;
+    }
+
+    if (! telemetryDirty)
+        return;
+
+    ++telemetryState.version;
+    uiTelemetry.getWriteBuffer() = telemetryState;
+    uiTelemetry.publish();
+    telemetryDirty = false;
 }
 
 // ── Main processing ──────────────────────────────────────────────────
 
 void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audioBuffer,
                                                     juce::MidiBuffer& midiMessages)
+{
+    TraceRecorder::Scope traceScope (tracer, TraceMarker::ProcessBlock, -1.0, audioBuffer.getNumSamples());
+    blackBox.recordInput (audioBuffer.getNumSamples(), getPlayHead(), midiMessages);
+
+    if (diagnosticsEnabled.load (std::memory_order_relaxed))
+        renderBlockWithDiagnostics (audioBuffer, midiMessages);
+    else
+        renderBlock (audioBuffer, midiMessages);
+
+    blackBox.recordOutput (midiMessages);
+}
+
+void GuitarStrumSequencerProcessor::renderBlockWithDiagnostics (juce::AudioBuffer<float>& audioBuffer,
+                                                                  juce::MidiBuffer& midiMessages)
+{
+    blockStats = {};
+    voicer.resetStats();
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    renderBlock (audioBuffer, midiMessages);
+
+    auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+    const auto& voicerStats = voicer.getStats();
+
+    blockStats.processMicros = static_cast<float> (
+        juce::Time::highResolutionTicksToSeconds (elapsedTicks) * 1.0e6);
+    blockStats.numSamples = static_cast<uint32_t> (audioBuffer.getNumSamples());
+    blockStats.voicerCalls = voicerStats.positionSearches;
+    blockStats.cacheHits = voicerStats.cacheHits;
+    blockStats.cacheMisses = voicerStats.cacheMisses;
+    blockStats.searchNodes = voicerStats.searchNodes;
+    blockStats.pendingDepth = static_cast<uint32_t> (pendingEvents.size());
+    blockStats.idle = isIdle;
+
+    diagnosticsFifo.push (blockStats);
+}
+
+void GuitarStrumSequencerProcessor::renderBlock (juce::AudioBuffer<float>& audioBuffer,
+                                                   juce::MidiBuffer& midiMessages)
 {
     audioBuffer.clear();
 
-    // Sync step velocities from parameters
-    for (int i = 0; i < StepSequencer::STEP_COUNT; ++i)
+    // Nothing held, sounding or pending and no notes/CCs arriving: the
+    // input MIDI passes through in place and the sequencer is skipped.
+    if (heldNotes.empty() && ! strumEngine.hasActiveNotes() && pendingEvents.empty()
+        && ! needsFullProcessing (midiMessages))
     {
-        auto* param = apvts.getRawParameterValue ("step" + juce::String (i + 1));
-        if (param != nullptr)
-            sequencer.setStepVelocity (i, param->load());
+        if (! isIdle)
+        {
+            // The sequencer re-quantizes to the transport when we wake up;
+            // the idle blocks keep the last step info current meanwhile
+            isIdle = true;
+            sequencer.reset();
+            nextBlockBeat = -1.0;
+        }
+
+        processIdleBlock();
+        publishTelemetry();
+        samplesProcessed += audioBuffer.getNumSamples();
+        return;
     }
 
+    isIdle = false;
+
+    syncPattern();
+
     bool voicingEnabled = apvts.getRawParameterValue ("guitarVoicing")->load() >= 0.5f;
 
     // Determine Position CC number
@@ -302,6 +655,7 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
     juce::MidiBuffer outputBuffer;
     bool noteOnInBlock = false;
     bool allNotesReleasedInBlock = false;
+    int lastNoteSample = -1;
 
     for (const auto metadata : midiMessages)
     {
@@ -309,6 +663,7 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
 
         if (msg.isNoteOn())
         {
+            lastNoteSample = metadata.samplePosition;
             insertSorted (heldNotes, msg.getNoteNumber());
             noteOnInBlock = true;
             allNotesReleasedInBlock = false;
@@ -317,6 +672,7 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
         }
         else if (msg.isNoteOff())
         {
+            lastNoteSample = metadata.samplePosition;
             removeFromArray (heldNotes, msg.getNoteNumber());
             if (heldNotes.empty())
             {
@@ -362,16 +718,12 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
     // noteOn resets allNotesReleasedInBlock to false.
     if (allNotesReleasedInBlock && heldNotes.empty())
     {
-        for (auto& note : strumEngine.getActiveNotes())
+        dropPendingStrikes (~0u);
+        strumEngine.releaseAll ([&outputBuffer] (int, const StrumEngine::ActiveNote& note)
         {
             outputBuffer.addEvent (
                 juce::MidiMessage::noteOff (note.channel, note.pitch, (juce::uint8) 0), 0);
-        }
-        strumEngine.clearActiveNotes();
-        pendingEvents.erase (
-            std::remove_if (pendingEvents.begin(), pendingEvents.end(),
-                [] (const PendingMidiEvent& e) { return e.message.isNoteOn(); }),
-            pendingEvents.end());
+        });
         lastStrumNotes.clear();
         lastStepHadNoNotes = true;
     }
@@ -411,16 +763,18 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
             double beatsPerSample = bpm / (60.0 * currentSampleRate);
             double blockStartBeat = ppqPosition;
             double blockEndBeat = ppqPosition + numSamples * beatsPerSample;
+            auto blockStartTick = beatToTick (blockStartBeat);
+            auto blockEndTick = beatToTick (blockEndBeat);
+            nextBlockBeat = blockEndBeat;
 
             // Detect transport stop → kill all active notes immediately
             if (! isPlaying && wasPlaying)
             {
-                for (auto& note : strumEngine.getActiveNotes())
+                strumEngine.releaseAll ([&outputBuffer] (int, const StrumEngine::ActiveNote& note)
                 {
                     outputBuffer.addEvent (
                         juce::MidiMessage::noteOff (note.channel, note.pitch, (juce::uint8) 0), 0);
-                }
-                strumEngine.clearActiveNotes();
+                });
                 pendingEvents.clear();
                 sequencer.reset();
                 lastStepHadNoNotes = false;
@@ -430,27 +784,44 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
             }
             wasPlaying = isPlaying;
 
+            if (bpm != telemetryState.bpm)
+            {
+                telemetryState.bpm = bpm;
+                telemetryDirty = true;
+            }
+
+            // Log the chord as it stands after this block's key changes
+            if (isPlaying && lastNoteSample >= 0)
+            {
+                ChordCapture capture {};
+                capture.beat = blockStartBeat + lastNoteSample * beatsPerSample;
+                for (auto note : heldNotes)
+                {
+                    if (capture.numNotes == capture.notes.size())
+                        break;
+                    capture.notes[capture.numNotes++] = static_cast<uint8_t> (note);
+                }
+                chordCaptureFifo.push (capture);
+            }
+
             // Prune stale pending events (e.g. after loop wraparound or seek)
             if (! pendingEvents.empty())
             {
-                double minPastBeat = blockStartBeat - 0.5;
-                double maxFutureBeat = blockEndBeat + 2.0;
-                pendingEvents.erase (
-                    std::remove_if (pendingEvents.begin(), pendingEvents.end(),
-                        [minPastBeat, maxFutureBeat] (const PendingMidiEvent& e)
-                        {
-                            return e.beatPosition < minPastBeat
-                                || e.beatPosition > maxFutureBeat;
-                        }),
-                    pendingEvents.end());
+                auto minPastTick = blockStartTick - PRUNE_PAST_TICKS;
+                auto maxFutureTick = blockEndTick + PRUNE_FUTURE_TICKS;
+                auto pruned = std::remove_if (pendingEvents.begin(), pendingEvents.end(),
+                    [minPastTick, maxFutureTick] (const PendingMidiEvent& e)
+                    {
+                        return e.tick < minPastTick
+                            || e.tick > maxFutureTick;
+                    });
+                blockStats.droppedEvents += static_cast<uint32_t> (std::distance (pruned, pendingEvents.end()));
+                pendingEvents.erase (pruned, pendingEvents.end());
             }
 
-            int subdivisionIndex = static_cast<int> (apvts.getRawParameterValue ("subdivision")->load());
-
             auto stepEvents = sequencer.processBlock (blockStartBeat, blockEndBeat,
                                                        isPlaying, isCycling,
-                                                       cycleStart, cycleEnd,
-                                                       subdivisionIndex);
+                                                       cycleStart, cycleEnd);
 
             float strumSpeed = apvts.getRawParameterValue ("strumSpeed")->load();
             float humanize = apvts.getRawParameterValue ("humanize")->load() / 100.0f;
@@ -459,28 +830,34 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
 
             for (auto& event : stepEvents)
             {
+                auto eventTick = beatToTick (event.beatPosition);
+
+                // A step the clock only caught up on after holding through
+                // host drift plays at the start of the block instead of
+                // being dropped as stale
+                if (eventTick < blockStartTick - LATE_EVENT_TICKS)
+                    eventTick = blockStartTick;
+
+                tracer.instant (TraceMarker::StepEvent, event.beatPosition, event.stepIndex);
+
                 // Always update UI step indicator
                 currentStepForUI.store (event.stepIndex);
 
-                // Read per-step direction from parameter
-                auto dirParamId = "dir" + juce::String (event.stepIndex + 1);
-                auto direction = static_cast<StepDirection> (
-                    static_cast<int> (apvts.getRawParameterValue (dirParamId)->load()));
+                // Direction comes from whichever pattern played the step
+                auto direction = event.direction;
 
                 // Record step info for potential re-trigger (even if empty/ghost)
                 lastStepIndex = event.stepIndex;
                 lastStepDirection = direction;
                 lastStepBeat = event.beatPosition;
                 lastStepVelocity = event.velocity;
+                lastStepStrumSpeedScale = event.strumSpeedScale;
 
                 // Rest step — silence and skip
                 if (direction == StepDirection::Rest)
                 {
-                    killActiveNotesAt (event.beatPosition - 0.0001);
-                    pendingEvents.erase (
-                        std::remove_if (pendingEvents.begin(), pendingEvents.end(),
-                            [] (const PendingMidiEvent& e) { return e.message.isNoteOn(); }),
-                        pendingEvents.end());
+                    dropPendingStrikes (~0u);
+                    killActiveNotesAt (eventTick);
                     lastStepHadNoNotes = false;
                     continue;
                 }
@@ -494,7 +871,10 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
                     // period when some keys are still held (rare voicing edge
                     // case) to bridge buffer boundaries.
                     if (lastStepHadNoNotes || heldNotes.empty())
-                        killActiveNotesAt (event.beatPosition);
+                    {
+                        dropPendingStrikes (~0u);
+                        killActiveNotesAt (eventTick);
+                    }
                     lastStepHadNoNotes = true;
                     continue;
                 }
@@ -504,29 +884,15 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
                 if (event.velocity <= 0.0f)
                     continue;   // ghost step — let previous strum ring
 
-                // Kill previous strum's notes slightly before the new step
-                // (tiny epsilon ensures NoteOff sorts before NoteOn at same beat)
-                killActiveNotesAt (event.beatPosition - 0.0001);
-
-                // Remove any orphaned pending NoteOns from the previous strum
-                // (they would play notes that are no longer tracked as active)
-                pendingEvents.erase (
-                    std::remove_if (pendingEvents.begin(), pendingEvents.end(),
-                        [] (const PendingMidiEvent& e) { return e.message.isNoteOn(); }),
-                    pendingEvents.end());
+                // Withdraw the previous strum's strings that have yet to
+                // sound (they are about to be re-struck or silenced)
+                dropPendingStrikes (~0u);
 
-                // Generate strum with beat-based offsets
-                auto strumNotes = strumEngine.generateStrum (
-                    notes, direction, event.velocity,
-                    strumSpeed, humanize, multiChannel, bpm);
-
-                // Schedule each strum note at stepBeat + individual beatOffset
-                for (auto& sn : strumNotes)
-                {
-                    scheduleEvent (
-                        juce::MidiMessage::noteOn (sn.channel, sn.pitch, (juce::uint8) sn.velocity),
-                        event.beatPosition + sn.beatOffset);
-                }
+                // Generate strum with beat-based offsets; previous notes are
+                // choked string by string as each string is re-struck
+                scheduleStrum (notes, notes, direction, event.velocity,
+                               strumSpeed * event.strumSpeedScale, humanize, multiChannel, bpm,
+                               eventTick);
 
                 lastStrumNotes = notes;
             }
@@ -534,7 +900,9 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
             // ── Re-trigger check ──────────────────────────────────────
             // When the track is selected, Logic may deliver chord-change
             // MIDI one buffer late.  If the chord changed since the last
-            // strum (or the strum was killed), regenerate immediately.
+            // strum (or the strum was killed), re-strike immediately — but
+            // only the strings whose pitch changed; common tones keep
+            // ringing so the late change doesn't sound like a double strum.
             // Only re-trigger when a noteOn arrived in this block —
             // note-offs changing the voicing should NOT cause extra strums.
             if (isPlaying && lastStepBeat >= 0.0 && noteOnInBlock)
@@ -544,7 +912,7 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
 
                 if (! currentNotes.empty())
                 {
-                    if (strumEngine.getActiveNotes().empty())
+                    if (! strumEngine.hasActiveNotes())
                         needsRetrigger = true;   // strum was killed (CC#120, grace period, etc.)
                     else if (currentNotes != lastStrumNotes)
                         needsRetrigger = true;   // chord changed since last strum
@@ -552,24 +920,19 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
 
                 if (needsRetrigger && lastStepDirection != StepDirection::Rest)
                 {
-                    killActiveNotesAt (blockStartBeat);
+                    ++blockStats.retriggers;
 
-                    // Remove pending NoteOns from the old strum
-                    pendingEvents.erase (
-                        std::remove_if (pendingEvents.begin(), pendingEvents.end(),
-                            [] (const PendingMidiEvent& e) { return e.message.isNoteOn(); }),
-                        pendingEvents.end());
+                    auto strikes = strumEngine.getChangedNotes (currentNotes);
+                    uint32_t commonTones = StrumEngine::slotMaskFor (currentNotes)
+                                         & ~StrumEngine::slotMaskFor (strikes);
 
-                    auto strumNotes = strumEngine.generateStrum (
-                        currentNotes, lastStepDirection, lastStepVelocity,
-                        strumSpeed, humanize, multiChannel, bpm);
+                    // Withdraw the old strum's strings that have yet to sound,
+                    // except common tones — they are left to ring
+                    dropPendingStrikes (~commonTones);
 
-                    for (auto& sn : strumNotes)
-                    {
-                        scheduleEvent (
-                            juce::MidiMessage::noteOn (sn.channel, sn.pitch, (juce::uint8) sn.velocity),
-                            blockStartBeat + sn.beatOffset);
-                    }
+                    scheduleStrum (currentNotes, strikes, lastStepDirection, lastStepVelocity,
+                                   strumSpeed * lastStepStrumSpeedScale, humanize, multiChannel, bpm,
+                                   blockStartTick);
 
                     lastStrumNotes = currentNotes;
                     lastStepHadNoNotes = false;
@@ -581,21 +944,28 @@ void GuitarStrumSequencerProcessor::processBlock (juce::AudioBuffer<float>& audi
             // After the transport wraps, these need to map into the new cycle.
             if (isCycling && cycleEnd > cycleStart && ! pendingEvents.empty())
             {
-                double cycleLength = cycleEnd - cycleStart;
-                for (auto& evt : pendingEvents)
+                auto cycleStartTick = beatToTick (cycleStart);
+                auto cycleEndTick = beatToTick (cycleEnd);
+                auto cycleLengthTicks = cycleEndTick - cycleStartTick;
+                if (cycleLengthTicks > 0)
                 {
-                    while (evt.beatPosition >= cycleEnd)
-                        evt.beatPosition -= cycleLength;
+                    for (auto& evt : pendingEvents)
+                    {
+                        if (evt.tick >= cycleEndTick)
+                            evt.tick = cycleStartTick + (evt.tick - cycleStartTick) % cycleLengthTicks;
+                    }
                 }
             }
 
             // Emit all pending events that fall within this block's beat range
-            emitPendingEvents (outputBuffer, blockStartBeat, blockEndBeat,
-                               beatsPerSample, numSamples);
+            emitPendingEvents (outputBuffer, blockStartTick, blockEndTick,
+                               beatsPerSample * static_cast<double> (TICKS_PER_BEAT), numSamples);
         }
     }
 
     midiMessages.swapWith (outputBuffer);
+    publishTelemetry();
+    samplesProcessed += audioBuffer.getNumSamples();
 }
 
 juce::AudioProcessorEditor* GuitarStrumSequencerProcessor::createEditor()
@@ -610,11 +980,25 @@ void GuitarStrumSequencerProcessor::getStateInformation (juce::MemoryBlock& dest
     copyXmlToBinary (*xml, destData);
 }
 
+bool GuitarStrumSequencerProcessor::dumpBlackBox (const juce::File& file)
+{
+    juce::MemoryBlock state;
+    getStateInformation (state);
+    return blackBox.dump (file, state);
+}
+
 void GuitarStrumSequencerProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
     std::unique_ptr<juce::XmlElement> xml (getXmlFromBinary (data, sizeInBytes));
     if (xml != nullptr && xml->hasTagName (apvts.state.getType()))
+    {
         apvts.replaceState (juce::ValueTree::fromXml (*xml));
+        songMode.stateChanged();
+
+        if (! GrooveFile::fromJson (juce::JSON::parse (apvts.state["grooveFile"].toString()), fileGroove))
+            fileGroove = {};
+        grooveFifo.push (fileGroove);
+    }
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -3,7 +3,15 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "GuitarVoicer.h"
 #include "StepSequencer.h"
+#include "SongMode.h"
+#include "GrooveFile.h"
 #include "StrumEngine.h"
+#include "UITelemetry.h"
+#include "SpscFifo.h"
+#include "Diagnostics.h"
+#include "OfflineRenderer.h"
+#include "TraceRecorder.h"
+#include "BlackBoxRecorder.h"
 
 class GuitarStrumSequencerProcessor : public juce::AudioProcessor
 {
@@ -36,59 +44,162 @@ public:
     void setStateInformation (const void* data, int sizeInBytes) override;
 
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
+    SongMode& getSongMode() { return songMode; }
 
     // Expose current step for GUI highlight
     std::atomic<int> currentStepForUI { -1 };
 
-    // Expose current voicing for fretboard diagram
-    VoicingResult getVoicingForUI() const { return currentVoicingForUI; }
-    bool isVoicingForUIValid() const { return voicingForUIValid.load(); }
+    // Latest playing-state snapshot for the editor (message thread only)
+    const UITelemetryFrame& getUITelemetry()
+    {
+        uiTelemetry.fetch();
+        return uiTelemetry.getReadBuffer();
+    }
+
+    // Strings struck by the audio thread, drained by the fretboard
+    bool popStringStrike (StringStrike& strike) { return strikeFifo.pop (strike); }
+
+    // Chord changes played while the transport ran, for clip export
+    bool popChordCapture (ChordCapture& capture) { return chordCaptureFifo.pop (capture); }
+
+    // Current parameter values as settings for an offline render
+    StrumSettings getStrumSettings();
+
+    // Loads a groove template (JSON, or a MIDI reference measured against
+    // the current grid) and selects it.  Message thread.
+    bool loadGrooveFile (const juce::File& file, juce::String& error);
+
+    // Per-block hot-path counters, collected only while switched on
+    std::atomic<bool> diagnosticsEnabled { false };
+    bool popBlockDiagnostics (BlockDiagnostics& stats) { return diagnosticsFifo.pop (stats); }
+
+    // Chrome trace capture of the audio thread's sections and step events
+    TraceRecorder& getTraceRecorder() { return tracer; }
+
+    // Rolling record of input MIDI, transport and output for offline replay
+    BlackBoxRecorder& getBlackBoxRecorder() { return blackBox; }
+    bool dumpBlackBox (const juce::File& file);
 
 private:
-    VoicingResult currentVoicingForUI;
-    std::atomic<bool> voicingForUIValid { false };
+    // Audio-thread view of the telemetry, published once per block on change
+    UITelemetryFrame telemetryState;
+    bool telemetryDirty = false;
+    TripleBuffer<UITelemetryFrame> uiTelemetry;
+    SpscFifo<StringStrike, 256> strikeFifo;
+    SpscFifo<ChordCapture, 1024> chordCaptureFifo;
+
+    BlockDiagnostics blockStats;
+    SpscFifo<BlockDiagnostics, 1024> diagnosticsFifo;
+
+    TraceRecorder tracer;
+    BlackBoxRecorder blackBox;
+
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    SongMode songMode { apvts };
+
     GuitarVoicer voicer;
     StepSequencer sequencer;
     StrumEngine strumEngine;
 
     // MIDI state
     std::vector<int> heldNotes;    // sorted ascending
-    std::vector<int> voicedNotes;  // guitar-voiced pitches (sorted ascending)
+    std::vector<StringPitch> voicedNotes;  // guitar-voiced pitches (low string first)
     int ccPositionOverride = -1;
     bool ccPositionUsed = false;
 
+    // Raw parameter values read every block, looked up once by ID
+    std::array<std::atomic<float>*, StepSequencer::MAX_STEPS> stepVelocityParams {};
+    std::array<std::atomic<float>*, StepSequencer::MAX_STEPS> stepDirectionParams {};
+    std::atomic<float>* subdivisionParam = nullptr;
+    std::atomic<float>* patternLengthParam = nullptr;
+    std::atomic<float>* grooveParam = nullptr;
+    std::atomic<float>* grooveAmountParam = nullptr;
+
+    // Groove loaded from a file: the message thread's copy is kept in the
+    // state and handed to the audio thread's through the fifo
+    GrooveTemplate fileGroove;
+    GrooveTemplate audioFileGroove;
+    SpscFifo<GrooveTemplate, 4> grooveFifo;
+
+    // The preset picked by the groove parameter, or the file's groove
+    const GrooveTemplate& selectGroove (const GrooveTemplate& fromFile) const;
+
     double currentSampleRate = 44100.0;
+    juce::int64 samplesProcessed = 0;  // sample count at the start of the current block
+    double nextBlockBeat = -1.0;       // where the last block ended, < 0 = unknown; for tracing
     bool wasPlaying = false;
+    bool isIdle = false;  // nothing held, sounding or pending
     bool lastStepHadNoNotes = false;  // grace period for chord transitions
 
     // Re-trigger state: detect chord changes that arrive one buffer late
-    std::vector<int> lastStrumNotes;
+    std::vector<StringPitch> lastStrumNotes;
     int lastStepIndex = 0;
     StepDirection lastStepDirection = StepDirection::Down;
     float lastStepVelocity = 0.0f;
+    float lastStepStrumSpeedScale = 1.0f;
     double lastStepBeat = -1.0;
 
-    // Beat-based pending MIDI event queue (for cross-buffer strum scheduling)
+    // Pending events live on an integer tick timeline so ordering is exact
+    // and doesn't drift over long sessions
+    static constexpr juce::int64 TICKS_PER_BEAT     = 960 * 1024;
+    static constexpr juce::int64 LATE_EVENT_TICKS   = TICKS_PER_BEAT / 10; // older than this → dropped
+    static constexpr juce::int64 PRUNE_PAST_TICKS   = TICKS_PER_BEAT / 2;
+    static constexpr juce::int64 PRUNE_FUTURE_TICKS = TICKS_PER_BEAT * 2;
+
+    // Events at the same tick are emitted NoteOff → other → NoteOn
+    enum EventPriority { PriorityNoteOff = 0, PriorityOther = 1, PriorityNoteOn = 2 };
+
+    static juce::int64 beatToTick (double beat);
+
+    // Tick-based pending MIDI event queue (for cross-buffer strum scheduling).
+    // Events are packed note messages; the MIDI bytes are only written into
+    // the MidiBuffer when an event is emitted.
     struct PendingMidiEvent
     {
-        juce::MidiMessage message;
-        double beatPosition;
+        juce::int64 tick;
+        juce::uint8 status;
+        juce::uint8 data1;
+        juce::uint8 data2;
+        juce::int8 slot;      // string/voice slot the note belongs to
+        juce::uint8 priority;
+
+        bool isNoteOn() const { return (status & 0xf0) == 0x90 && data2 > 0; }
     };
+    static_assert (sizeof (PendingMidiEvent) <= 16, "PendingMidiEvent should stay packed");
+
+    static constexpr size_t PENDING_EVENT_CAPACITY = 1024;
     std::vector<PendingMidiEvent> pendingEvents;
 
     void insertSorted (std::vector<int>& arr, int pitch);
     void removeFromArray (std::vector<int>& arr, int pitch);
     void updateVoicedNotes();
-    std::vector<int> getNotesToStrum();
-    void scheduleEvent (const juce::MidiMessage& msg, double beatPos);
-    void emitPendingEvents (juce::MidiBuffer& buffer, double blockStartBeat,
-                            double blockEndBeat, double beatsPerSample, int numSamples);
-    void killActiveNotesAt (double beatPos);
+    std::vector<StringPitch> getNotesToStrum();
+    void scheduleNoteOn (int channel, int pitch, int velocity, int slot, juce::int64 tick);
+    void scheduleNoteOff (int channel, int pitch, int slot, juce::int64 tick);
+    void scheduleStrum (const std::vector<StringPitch>& voicing,
+                        const std::vector<StringPitch>& strikes, StepDirection direction,
+                        float velocity, float strumSpeed, float humanize,
+                        bool multiChannel, double bpm, juce::int64 strumTick);
+    void emitPendingEvents (juce::MidiBuffer& buffer, juce::int64 blockStartTick,
+                            juce::int64 blockEndTick, double ticksPerSample, int numSamples);
+    void recordTimingError (double errorSamples);
+    void killActiveNotesAt (juce::int64 tick);
+
+    // Withdraws the pending strikes on the slots in slotMask, see
+    // StrumEngine::withdrawStrikes
+    void dropPendingStrikes (uint32_t slotMask);
 
     VoicingParams readVoicingParams();
+    void syncPattern();   // pattern length, grid, step velocities and directions from the parameters
+
+    void renderBlock (juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages);
+    void renderBlockWithDiagnostics (juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages);
+
+    static bool needsFullProcessing (const juce::MidiBuffer& midi);
+    void processIdleBlock();
+    void publishTelemetry();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GuitarStrumSequencerProcessor)
 };
@@ -0,0 +1,62 @@
+#include "SongArrangement.h"
+#include <algorithm>
+#include <limits>
+
+SongArrangement::SongArrangement (std::vector<StepSequencer::Pattern> bank,
+                                  std::vector<Section> sections,
+                                  double beatsPerBar)
+    : patterns (std::move (bank))
+{
+    for (auto& pattern : patterns)
+        pattern.compile();
+
+    // Paint each section over the bars in order, then merge runs of bars
+    // playing the same pattern into spans
+    constexpr int maxBars = 10000;
+    int lastBar = 0;
+    for (const auto& section : sections)
+        if (section.patternIndex >= 0 && section.patternIndex < static_cast<int> (patterns.size()))
+            lastBar = std::max (lastBar, std::min (section.lastBar, maxBars));
+
+    std::vector<int> patternAtBar (static_cast<size_t> (lastBar) + 1, -1);
+    for (const auto& section : sections)
+    {
+        if (section.patternIndex < 0 || section.patternIndex >= static_cast<int> (patterns.size()))
+            continue;
+
+        for (int bar = std::max (1, section.firstBar); bar <= std::min (section.lastBar, lastBar); ++bar)
+            patternAtBar[static_cast<size_t> (bar)] = section.patternIndex;
+    }
+
+    for (int bar = 1; bar <= lastBar; ++bar)
+    {
+        int index = patternAtBar[static_cast<size_t> (bar)];
+        const auto* pattern = index >= 0 ? &patterns[static_cast<size_t> (index)] : nullptr;
+        double start = (bar - 1) * beatsPerBar;
+
+        if (! timeline.empty() && timeline.back().pattern == pattern)
+            timeline.back().endBeat = start + beatsPerBar;
+        else if (pattern != nullptr || ! timeline.empty())
+            timeline.push_back ({ pattern, start, start + beatsPerBar });
+    }
+}
+
+SongArrangement::Span SongArrangement::find (double beat) const
+{
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+
+    if (timeline.empty())
+        return { nullptr, -infinity, infinity };
+
+    auto it = std::upper_bound (timeline.begin(), timeline.end(), beat,
+                                [] (double b, const Span& span) { return b < span.startBeat; });
+
+    if (it == timeline.begin())
+        return { nullptr, -infinity, timeline.front().startBeat };
+
+    --it;
+    if (beat >= it->endBeat)
+        return { nullptr, timeline.back().endBeat, infinity };
+
+    return *it;
+}
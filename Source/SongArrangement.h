@@ -0,0 +1,40 @@
+#pragma once
+
+#include "StepSequencer.h"
+#include <vector>
+
+// A bank of strum patterns and the bar ranges they play over, compiled into
+// a sorted timeline.  Immutable once built, so the audio thread can read one
+// while the editor builds its replacement.
+class SongArrangement
+{
+public:
+    struct Section
+    {
+        int patternIndex;   // into the bank
+        int firstBar;       // 1-based, inclusive
+        int lastBar;
+    };
+
+    // Later sections win where sections overlap; sections naming a pattern
+    // outside the bank are ignored
+    SongArrangement (std::vector<StepSequencer::Pattern> bank,
+                     std::vector<Section> sections,
+                     double beatsPerBar = 4.0);
+
+    struct Span
+    {
+        const StepSequencer::Pattern* pattern;   // nullptr = no section here
+        double startBeat;
+        double endBeat;
+    };
+
+    // Span containing `beat`, found by binary search over the timeline
+    Span find (double beat) const;
+
+    size_t getNumSpans() const { return timeline.size(); }
+
+private:
+    std::vector<StepSequencer::Pattern> patterns;
+    std::vector<Span> timeline;   // sorted, contiguous from the first section to the last
+};
@@ -0,0 +1,225 @@
+#include "SongMode.h"
+#include <algorithm>
+
+namespace
+{
+    const juce::Identifier songId ("Song");
+    const juce::Identifier patternId ("Pattern");
+    const juce::Identifier enabledId ("enabled");
+    const juce::Identifier arrangementId ("arrangement");
+    const juce::Identifier slotId ("slot");
+    const juce::Identifier numStepsId ("numSteps");
+    const juce::Identifier subdivisionId ("subdivision");
+    const juce::Identifier velocitiesId ("velocities");
+    const juce::Identifier directionsId ("directions");
+
+    float readParam (juce::AudioProcessorValueTreeState& apvts, const juce::String& id)
+    {
+        return apvts.getRawParameterValue (id)->load();
+    }
+
+    void writeParam (juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float value)
+    {
+        if (auto* param = apvts.getParameter (id))
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+}
+
+SongMode::SongMode (juce::AudioProcessorValueTreeState& a)
+    : apvts (a)
+{
+}
+
+SongMode::~SongMode()
+{
+    published.store (nullptr);
+}
+
+juce::ValueTree SongMode::getSongState() const
+{
+    return apvts.state.getOrCreateChildWithName (songId, nullptr);
+}
+
+juce::ValueTree SongMode::getSlotState (int slot) const
+{
+    auto song = getSongState();
+    for (int i = 0; i < song.getNumChildren(); ++i)
+    {
+        auto child = song.getChild (i);
+        if (child.hasType (patternId) && static_cast<int> (child[slotId]) == slot)
+            return child;
+    }
+    return {};
+}
+
+bool SongMode::hasPattern (int slot) const
+{
+    return getSlotState (slot).isValid();
+}
+
+void SongMode::storePattern (int slot)
+{
+    if (slot < 0 || slot >= NUM_SLOTS)
+        return;
+
+    int numSteps = static_cast<int> (readParam (apvts, "patternLength"));
+
+    juce::StringArray velocities, directions;
+    for (int i = 0; i < numSteps; ++i)
+    {
+        velocities.add (juce::String (static_cast<int> (readParam (apvts, "step" + juce::String (i + 1)))));
+        directions.add (juce::String (static_cast<int> (readParam (apvts, "dir" + juce::String (i + 1)))));
+    }
+
+    auto song = getSongState();
+    auto pattern = getSlotState (slot);
+    if (! pattern.isValid())
+    {
+        pattern = juce::ValueTree (patternId);
+        pattern.setProperty (slotId, slot, nullptr);
+        song.appendChild (pattern, nullptr);
+    }
+
+    pattern.setProperty (numStepsId, numSteps, nullptr);
+    pattern.setProperty (subdivisionId, static_cast<int> (readParam (apvts, "subdivision")), nullptr);
+    pattern.setProperty (velocitiesId, velocities.joinIntoString (" "), nullptr);
+    pattern.setProperty (directionsId, directions.joinIntoString (" "), nullptr);
+
+    publish();
+}
+
+void SongMode::recallPattern (int slot)
+{
+    auto pattern = getSlotState (slot);
+    if (! pattern.isValid())
+        return;
+
+    auto velocities = juce::StringArray::fromTokens (pattern[velocitiesId].toString(), false);
+    auto directions = juce::StringArray::fromTokens (pattern[directionsId].toString(), false);
+
+    writeParam (apvts, "patternLength", static_cast<float> (static_cast<int> (pattern[numStepsId])));
+    writeParam (apvts, "subdivision", static_cast<float> (static_cast<int> (pattern[subdivisionId])));
+
+    for (int i = 0; i < velocities.size() && i < StepSequencer::MAX_STEPS; ++i)
+        writeParam (apvts, "step" + juce::String (i + 1), velocities[i].getFloatValue());
+    for (int i = 0; i < directions.size() && i < StepSequencer::MAX_STEPS; ++i)
+        writeParam (apvts, "dir" + juce::String (i + 1), directions[i].getFloatValue());
+}
+
+bool SongMode::parseArrangement (const juce::String& text, std::vector<SongArrangement::Section>& sections,
+                                 juce::String& error)
+{
+    juce::StringArray entries;
+    entries.addTokens (text, ",\n", "");
+    entries.trim();
+    entries.removeEmptyStrings();
+
+    for (const auto& entry : entries)
+    {
+        int slot = static_cast<int> (entry.toUpperCase()[0]) - 'A';
+        auto range = entry.substring (1).trim();
+        int firstBar = range.upToFirstOccurrenceOf ("-", false, false).getIntValue();
+        int lastBar = range.containsChar ('-') ? range.fromFirstOccurrenceOf ("-", false, false).getIntValue()
+                                               : firstBar;
+
+        if (slot < 0 || slot >= NUM_SLOTS || firstBar < 1 || lastBar < firstBar)
+        {
+            error = "Can't read \"" + entry + "\" (expected e.g. A 1-8)";
+            return false;
+        }
+
+        sections.push_back ({ slot, firstBar, lastBar });
+    }
+
+    return true;
+}
+
+bool SongMode::setArrangement (const juce::String& text, juce::String& error)
+{
+    std::vector<SongArrangement::Section> sections;
+    if (! parseArrangement (text, sections, error))
+        return false;
+
+    getSongState().setProperty (arrangementId, text.trim(), nullptr);
+    publish();
+    return true;
+}
+
+juce::String SongMode::getArrangementText() const
+{
+    return getSongState()[arrangementId].toString();
+}
+
+void SongMode::setEnabled (bool shouldBeEnabled)
+{
+    getSongState().setProperty (enabledId, shouldBeEnabled, nullptr);
+    publish();
+}
+
+bool SongMode::isEnabled() const
+{
+    return static_cast<bool> (getSongState()[enabledId]);
+}
+
+void SongMode::stateChanged()
+{
+    publish();
+}
+
+void SongMode::publish()
+{
+    std::unique_ptr<const SongArrangement> arrangement;
+
+    if (isEnabled())
+    {
+        // Only stored slots go into the bank; sections naming an empty
+        // slot fall back to the live pattern
+        std::vector<StepSequencer::Pattern> bank;
+        std::array<int, NUM_SLOTS> bankIndex;
+        bankIndex.fill (-1);
+
+        for (int slot = 0; slot < NUM_SLOTS; ++slot)
+        {
+            auto state = getSlotState (slot);
+            if (! state.isValid())
+                continue;
+
+            StepSequencer::Pattern pattern;
+            pattern.numSteps = static_cast<int> (state[numStepsId]);
+            pattern.subdivisionIndex = static_cast<int> (state[subdivisionId]);
+
+            auto velocities = juce::StringArray::fromTokens (state[velocitiesId].toString(), false);
+            auto directions = juce::StringArray::fromTokens (state[directionsId].toString(), false);
+            for (int i = 0; i < velocities.size() && i < StepSequencer::MAX_STEPS; ++i)
+                pattern.velocities[static_cast<size_t> (i)] = velocities[i].getFloatValue();
+            for (int i = 0; i < directions.size() && i < StepSequencer::MAX_STEPS; ++i)
+                pattern.directions[static_cast<size_t> (i)] = static_cast<StepDirection> (juce::jlimit (0, 2, directions[i].getIntValue()));
+
+            bankIndex[static_cast<size_t> (slot)] = static_cast<int> (bank.size());
+            bank.push_back (pattern);
+        }
+
+        std::vector<SongArrangement::Section> sections;
+        juce::String error;
+        parseArrangement (getArrangementText(), sections, error);
+
+        for (auto& section : sections)
+            section.patternIndex = bankIndex[static_cast<size_t> (section.patternIndex)];
+
+        arrangement = std::make_unique<const SongArrangement> (std::move (bank), std::move (sections));
+    }
+
+    published.store (arrangement.get(), std::memory_order_release);
+    if (arrangement != nullptr)
+        retained.push_back (std::move (arrangement));
+
+    // Once the audio thread has picked up the latest arrangement it can
+    // never load an older one again, so those can go
+    auto* current = published.load (std::memory_order_acquire);
+    if (inUse.load (std::memory_order_acquire) == current)
+    {
+        retained.erase (std::remove_if (retained.begin(), retained.end(),
+                                        [current] (const auto& a) { return a.get() != current; }),
+                        retained.end());
+    }
+}
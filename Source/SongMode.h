@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "SongArrangement.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Song mode: a bank of stored strum patterns (A-H) and an arrangement of
+// bar ranges to play them over, kept in the plugin state.  Every change is
+// compiled into a new immutable SongArrangement and handed to the audio
+// thread with one atomic pointer swap.
+class SongMode
+{
+public:
+    static constexpr int NUM_SLOTS = 8;
+
+    explicit SongMode (juce::AudioProcessorValueTreeState& apvts);
+    ~SongMode();
+
+    // Message thread
+    void storePattern (int slot);    // live step parameters → slot
+    void recallPattern (int slot);   // slot → live step parameters
+    bool hasPattern (int slot) const;
+
+    // Arrangement as text, one section per line or comma: "A 1-8, B 9-16"
+    bool setArrangement (const juce::String& text, juce::String& error);
+    juce::String getArrangementText() const;
+
+    void setEnabled (bool shouldBeEnabled);
+    bool isEnabled() const;
+
+    // Rebuilds the arrangement after the plugin state was replaced
+    void stateChanged();
+
+    static juce::String getSlotName (int slot) { return juce::String::charToString (static_cast<juce::juce_wchar> ('A' + slot)); }
+
+    // Audio thread: the arrangement to play this block (nullptr = off)
+    const SongArrangement* acquire() noexcept
+    {
+        auto* current = published.load (std::memory_order_acquire);
+        inUse.store (current, std::memory_order_release);
+        return current;
+    }
+
+private:
+    juce::AudioProcessorValueTreeState& apvts;
+
+    std::atomic<const SongArrangement*> published { nullptr };
+    std::atomic<const SongArrangement*> inUse { nullptr };
+    std::vector<std::unique_ptr<const SongArrangement>> retained;   // message thread only
+
+    juce::ValueTree getSongState() const;
+    juce::ValueTree getSlotState (int slot) const;
+    static bool parseArrangement (const juce::String& text, std::vector<SongArrangement::Section>& sections,
+                                  juce::String& error);
+
+    void publish();
+
+    JUCE_DECLARE_NON_COPYABLE (SongMode)
+};
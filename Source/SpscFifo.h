@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Wait-free single-producer / single-consumer ring of trivially copyable
+// records.  push() drops the record when the ring is full, so the
+// producer (the audio thread) never blocks or allocates.
+template <typename T, size_t Capacity>
+class SpscFifo
+{
+    static_assert ((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool push (const T& item) noexcept
+    {
+        auto w = writePos.load (std::memory_order_relaxed);
+        if (w - readPos.load (std::memory_order_acquire) >= Capacity)
+            return false;
+
+        items[w & (Capacity - 1)] = item;
+        writePos.store (w + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side: number of records push() is guaranteed to accept
+    size_t getFreeSpace() const noexcept
+    {
+        return Capacity - (writePos.load (std::memory_order_relaxed) - readPos.load (std::memory_order_acquire));
+    }
+
+    bool pop (T& item) noexcept
+    {
+        auto r = readPos.load (std::memory_order_relaxed);
+        if (r == writePos.load (std::memory_order_acquire))
+            return false;
+
+        item = items[r & (Capacity - 1)];
+        readPos.store (r + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> items {};
+    alignas (64) std::atomic<size_t> writePos { 0 };
+    alignas (64) std::atomic<size_t> readPos { 0 };
+};
@@ -1,5 +1,41 @@
 #include "StepSequencer.h"
+#include "SongArrangement.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+
+StepSequencer::Pattern::Pattern()
+{
+    for (size_t i = 0; i < directions.size(); ++i)
+        directions[i] = (i % 2 == 0) ? StepDirection::Down : StepDirection::Up;
+
+    lengths.fill (1.0f);
+    compile();
+}
+
+void StepSequencer::Pattern::compile()
+{
+    numSteps = std::clamp (numSteps, 1, MAX_STEPS);
+    subdivisionIndex = std::clamp (subdivisionIndex, 0, NUM_SUBDIVISIONS - 1);
+
+    double grid = SUBDIVISION_BEATS[static_cast<size_t> (subdivisionIndex)];
+    double onset = 0.0;
+
+    for (int i = 0; i < numSteps; ++i)
+    {
+        onsets[static_cast<size_t> (i)] = onset;
+        onset += grid * std::clamp (lengths[static_cast<size_t> (i)], 0.25f, 4.0f);
+    }
+    onsets[static_cast<size_t> (numSteps)] = onset;
+}
+
+int StepSequencer::Pattern::findStep (double offset) const
+{
+    // Small epsilon handles floating-point imprecision at exact boundaries
+    auto first = onsets.begin();
+    int step = static_cast<int> (std::upper_bound (first, first + numSteps, offset + 1e-6) - first) - 1;
+    return std::max (step, 0);
+}
 
 StepSequencer::StepSequencer()
 {
@@ -8,43 +44,199 @@ StepSequencer::StepSequencer()
 
 void StepSequencer::setStepVelocity (int step, float velocity)
 {
-    if (step >= 0 && step < STEP_COUNT)
-        stepVelocities[static_cast<size_t> (step)] = velocity;
+    if (step >= 0 && step < MAX_STEPS)
+        livePattern.velocities[static_cast<size_t> (step)] = velocity;
 }
 
 float StepSequencer::getStepVelocity (int step) const
 {
-    if (step >= 0 && step < STEP_COUNT)
-        return stepVelocities[static_cast<size_t> (step)];
+    if (step >= 0 && step < MAX_STEPS)
+        return livePattern.velocities[static_cast<size_t> (step)];
     return 0.0f;
 }
 
-double StepSequencer::getStepDuration (int subdivisionIndex)
+void StepSequencer::setStepDirection (int step, StepDirection direction)
+{
+    if (step >= 0 && step < MAX_STEPS)
+        livePattern.directions[static_cast<size_t> (step)] = direction;
+}
+
+void StepSequencer::setPattern (int numSteps, int subdivisionIndex)
+{
+    numSteps = std::clamp (numSteps, 1, MAX_STEPS);
+    subdivisionIndex = std::clamp (subdivisionIndex, 0, NUM_SUBDIVISIONS - 1);
+
+    if (numSteps != livePattern.numSteps || subdivisionIndex != livePattern.subdivisionIndex)
+    {
+        livePattern.numSteps = numSteps;
+        livePattern.subdivisionIndex = subdivisionIndex;
+        patternDirty = true;
+    }
+}
+
+void StepSequencer::setStepLength (int step, float gridSteps)
+{
+    if (step < 0 || step >= MAX_STEPS)
+        return;
+
+    gridSteps = std::clamp (gridSteps, 0.25f, 4.0f);
+    if (livePattern.lengths[static_cast<size_t> (step)] != gridSteps)
+    {
+        livePattern.lengths[static_cast<size_t> (step)] = gridSteps;
+        patternDirty = true;
+    }
+}
+
+void StepSequencer::setArrangement (const SongArrangement* newArrangement)
+{
+    if (newArrangement == arrangement)
+        return;
+
+    // Scheduled steps belong to the old timeline, and the segment may point
+    // into the arrangement being retired; drop both and pick up on the new one
+    arrangement = newArrangement;
+    segment = { &livePattern, 0.0, 0.0 };
+    groovePattern = nullptr;
+    nextStepBeat = -1.0;
+    clockBeat = -1.0;
+}
+
+void StepSequencer::setGroove (const GrooveTemplate& newGroove, float amount)
+{
+    amount = std::clamp (amount, 0.0f, 1.0f);
+    if (amount == grooveAmount && newGroove == groove)
+        return;
+
+    groove = newGroove;
+    grooveAmount = amount;
+    groovePattern = nullptr;
+}
+
+void StepSequencer::resolveGroove()
+{
+    const auto& pattern = *segment.pattern;
+    groovePattern = &pattern;
+
+    for (int i = 0; i < pattern.numSteps; ++i)
+    {
+        auto index = static_cast<size_t> (i);
+        auto& resolved = grooveTable[index];
+
+        if (groove.numSteps == 0 || grooveAmount <= 0.0f)
+        {
+            resolved = {};
+            continue;
+        }
+
+        const auto& step = groove.steps[static_cast<size_t> (i % groove.numSteps)];
+        double grid = SUBDIVISION_BEATS[static_cast<size_t> (pattern.subdivisionIndex)];
+
+        // Keep within 45% of the shorter neighbouring step, so grooved
+        // steps can never swap order
+        auto previous = static_cast<size_t> ((i + pattern.numSteps - 1) % pattern.numSteps);
+        double limit = 0.45 * std::min (pattern.onsets[index + 1] - pattern.onsets[index],
+                                        pattern.onsets[previous + 1] - pattern.onsets[previous]);
+
+        resolved.offset = std::clamp (step.timing * grooveAmount * grid, -limit, limit);
+        resolved.velocity = std::max (0.0f, 1.0f + (step.velocity - 1.0f) * grooveAmount);
+        resolved.strumSpeed = std::max (0.0f, 1.0f + (step.strumSpeed - 1.0f) * grooveAmount);
+    }
+}
+
+StepSequencer::Segment StepSequencer::findSegment (double beat) const
 {
-    return (subdivisionIndex == 0) ? SUBDIV_8TH : SUBDIV_16TH;
+    if (arrangement == nullptr)
+        return { &livePattern, 0.0, std::numeric_limits<double>::infinity() };
+
+    // Sections anchor their pattern at the section start; the live
+    // pattern stays anchored at beat 0 between them
+    auto span = arrangement->find (beat);
+    if (span.pattern == nullptr)
+        return { &livePattern, 0.0, span.endBeat };
+
+    return { span.pattern, span.startBeat, span.endBeat };
 }
 
-double StepSequencer::quantizeToStep (double beat, double stepDuration)
+void StepSequencer::seekToStep (double beat, double lateness)
 {
-    // Use floor to land on the step boundary at-or-just-before the beat.
+    segment = findSegment (beat);
+    if (segment.pattern != groovePattern)
+        resolveGroove();
+
+    const auto& pattern = *segment.pattern;
+    double cycleLength = pattern.getCycleLength();
+
     // Small epsilon handles floating-point imprecision at exact boundaries
-    // (e.g. beat -0.0000001 should resolve to 0.0, not -stepDuration).
-    double result = std::floor ((beat + 1e-6) / stepDuration) * stepDuration;
+    // (e.g. beat -0.0000001 should resolve to 0.0, not the previous step).
+    double position = beat - segment.anchorBeat;
+    nextStepCycle = static_cast<int64_t> (std::floor ((position + 1e-6) / cycleLength));
+    double offset = position - static_cast<double> (nextStepCycle) * cycleLength;
 
-    // If we're past the midpoint of a step, the current step was already
-    // handled — target the next boundary instead.
-    if (beat - result > stepDuration * 0.5)
-        result += stepDuration;
+    currentStep = pattern.findStep (offset);
+    auto index = static_cast<size_t> (currentStep);
+    nextStepBeat = segment.anchorBeat + static_cast<double> (nextStepCycle) * cycleLength + pattern.onsets[index]
+                 + grooveTable[index].offset;
 
-    return result;
+    if (offset - pattern.onsets[index] > (pattern.onsets[index + 1] - pattern.onsets[index]) * lateness + 1e-6)
+        advanceStep();
 }
 
-int StepSequencer::calculateStepIndex (double beat, double stepDuration)
+void StepSequencer::advanceStep()
 {
-    double patternLength = STEP_COUNT * stepDuration;
-    double pos = std::fmod (beat, patternLength);
-    if (pos < 0.0) pos += patternLength;
-    return static_cast<int> (std::floor (pos / stepDuration)) % STEP_COUNT;
+    const auto& pattern = *segment.pattern;
+
+    if (++currentStep == pattern.numSteps)
+    {
+        currentStep = 0;
+        ++nextStepCycle;
+    }
+
+    auto index = static_cast<size_t> (currentStep);
+    double gridBeat = segment.anchorBeat + static_cast<double> (nextStepCycle) * pattern.getCycleLength()
+                    + pattern.onsets[index];
+
+    // The next pattern takes over at the section boundary
+    if (gridBeat >= segment.endBeat - 1e-6)
+        seekToStep (segment.endBeat, 0.0);
+    else
+        nextStepBeat = gridBeat + grooveTable[index].offset;
+}
+
+StepSequencer::StepEvent StepSequencer::getStepAt (double beat)
+{
+    if (patternDirty)
+    {
+        livePattern.compile();
+        patternDirty = false;
+        groovePattern = nullptr;
+        clockBeat = -1.0;
+    }
+
+    auto at = findSegment (beat);
+    const auto& pattern = *at.pattern;
+    double cycleLength = pattern.getCycleLength();
+    double position = beat - at.anchorBeat;
+    double cycleStart = std::floor ((position + 1e-6) / cycleLength) * cycleLength;
+    int step = pattern.findStep (position - cycleStart);
+    auto index = static_cast<size_t> (step);
+
+    // The groove table only holds the pattern last scheduled from
+    GrooveStep grooved;
+    if (at.pattern == groovePattern)
+        grooved = grooveTable[index];
+
+    return { at.anchorBeat + cycleStart + pattern.onsets[index] + grooved.offset, step,
+             pattern.velocities[index] * grooved.velocity, pattern.directions[index], grooved.strumSpeed };
+}
+
+void StepSequencer::resync (double beat)
+{
+    clockBeat = beat;
+    driftBlocks = 0;
+
+    // If we're past the midpoint of a step, the current step was already
+    // handled — target the next boundary instead.
+    seekToStep (beat, 0.5);
 }
 
 std::vector<StepSequencer::StepEvent> StepSequencer::processBlock (
@@ -53,86 +245,121 @@ std::vector<StepSequencer::StepEvent> StepSequencer::processBlock (
     bool isPlaying,
     bool isCycling,
     double cycleStart,
-    double cycleEnd,
-    int subdivisionIndex)
+    double cycleEnd)
 {
     std::vector<StepEvent> events;
 
     if (! isPlaying)
     {
-        previousBlockEnd = -1.0;
+        clockBeat = -1.0;
         return events;
     }
 
-    double stepDuration = getStepDuration (subdivisionIndex);
-
-    // Detect transport jump (user seek, etc.) and reinitialize if needed.
-    // After a cycle wrap, nextStepBeat is already set correctly by the wrap
-    // logic below, so we must NOT blindly reinit on every backward jump.
-    bool needsReinit = (nextStepBeat < 0.0);
-
-    if (! needsReinit && previousBlockEnd > 0.0
-        && blockStartBeat < previousBlockEnd - stepDuration)
+    // Scheduled steps belong to the old grid; pick up on the new one
+    if (patternDirty)
     {
-        // Backward jump detected — only reinit if nextStepBeat is unreasonable
-        // (cycle wrap already positioned it correctly near cycleStart)
-        if (nextStepBeat > blockEndBeat + stepDuration * STEP_COUNT)
-            needsReinit = true;
+        livePattern.compile();
+        patternDirty = false;
+        groovePattern = nullptr;
+        clockBeat = -1.0;
     }
 
-    // Forward jump: nextStepBeat is far behind the current position
-    if (! needsReinit && nextStepBeat < blockStartBeat - stepDuration)
-        needsReinit = true;
-
-    // nextStepBeat way ahead (shouldn't happen, but guard)
-    if (! needsReinit && nextStepBeat > blockEndBeat + stepDuration * STEP_COUNT)
-        needsReinit = true;
+    // A new groove applies from the next step scheduled
+    if (groovePattern == nullptr && nextStepBeat >= 0.0)
+        resolveGroove();
 
-    previousBlockEnd = blockEndBeat;
+    double blockLength = std::max (0.0, blockEndBeat - blockStartBeat);
 
-    if (needsReinit)
+    // Compare the host position with where the clock expected this block
+    // to start, and only treat a sustained or large error as a new position
+    if (nextStepBeat < 0.0 || clockBeat < 0.0)
+    {
+        resync (blockStartBeat);
+    }
+    else
     {
-        nextStepBeat = quantizeToStep (blockStartBeat, stepDuration);
-        currentStep = calculateStepIndex (nextStepBeat, stepDuration);
+        double errorSteps = std::abs (blockStartBeat - clockBeat) / getMeanStepDuration();
+
+        if (errorSteps > JUMP_THRESHOLD)
+        {
+            resync (blockStartBeat);
+        }
+        else if (errorSteps > LOCK_WINDOW && ++driftBlocks >= DRIFT_BLOCKS)
+        {
+            resync (blockStartBeat);
+        }
+        else
+        {
+            if (errorSteps <= LOCK_WINDOW)
+                driftBlocks = 0;
+
+            clockBeat += (blockStartBeat - clockBeat) * PLL_GAIN;
+        }
     }
 
     // Validate cycle parameters — only use cycling if the range is sensible
-    bool validCycle = isCycling && (cycleEnd > cycleStart + stepDuration * 0.5);
+    bool validCycle = isCycling && (cycleEnd > cycleStart + getMeanStepDuration() * 0.5);
 
-    // Scan for step boundaries within this block (with safety limit).
-    // No ">= blockStartBeat" check: after floor-based quantization or cycle
-    // wrap, nextStepBeat may be up to 1 step before blockStartBeat, and we
-    // still want to emit that event (it gets placed at sample 0 by the caller).
+    // Scan the clock's span of this block for step boundaries (with safety
+    // limit).  Step beats come straight from the onset table; the caller
+    // places one that falls just outside the host's span at sample 0 or in
+    // the next block.
+    double clockEnd = clockBeat + blockLength;
     int iterations = 0;
-    while (nextStepBeat < blockEndBeat && iterations < MAX_STEPS_PER_BLOCK)
+    while (nextStepBeat < clockEnd && iterations < MAX_STEPS_PER_BLOCK)
     {
+        // Steps on the grid from cycleEnd on belong to the next pass, after
+        // the wrap (even when a groove pulls them ahead of it)
+        if (validCycle && getNextStepGridBeat() >= cycleEnd - 1e-6)
+            break;
+
         ++iterations;
 
         // Use the unwrapped beat position for scheduling.  The block's beat
         // range is in absolute (unwrapped) space, so the event must match.
         // processBlock handles cycle normalisation for any pending events that
         // end up past cycleEnd (e.g. strum notes that spread across the boundary).
-        float vel = stepVelocities[static_cast<size_t> (currentStep)];
-
-        events.push_back ({ nextStepBeat, currentStep, vel });
+        emitStep (events, 0.0);
+    }
 
-        // Advance
-        nextStepBeat += stepDuration;
-        currentStep = (currentStep + 1) % STEP_COUNT;
+    // Advance by exactly this block; a cycling transport wraps the clock
+    // the same way the host wraps its position
+    clockBeat = clockEnd;
+    if (validCycle && clockBeat >= cycleEnd)
+    {
+        double cycleLength = cycleEnd - cycleStart;
+        clockBeat -= cycleLength;
 
-        // Stop scanning once we've passed the cycle end.  Don't wrap
-        // nextStepBeat here — the transport will handle the actual position
-        // change, and reinit will pick up the new position.
-        if (validCycle && nextStepBeat >= cycleEnd)
-            break;
+        // The next pass starts from its first step at or after cycleStart,
+        // wherever the loop length leaves it on the grid.  Steps the block
+        // already covers after the wrap play now, in unwrapped space; a step
+        // grooved past the loop end is dropped with the rest of the pass.
+        seekToStep (cycleStart, 0.0);
+        while (nextStepBeat < clockBeat && iterations < MAX_STEPS_PER_BLOCK)
+        {
+            ++iterations;
+            emitStep (events, cycleLength);
+        }
     }
 
     return events;
 }
 
+void StepSequencer::emitStep (std::vector<StepEvent>& events, double beatShift)
+{
+    auto index = static_cast<size_t> (currentStep);
+    const auto& grooved = grooveTable[index];
+    events.push_back ({ nextStepBeat + beatShift, currentStep,
+                        segment.pattern->velocities[index] * grooved.velocity,
+                        segment.pattern->directions[index], grooved.strumSpeed });
+    advanceStep();
+}
+
 void StepSequencer::reset()
 {
     currentStep = -1;
     nextStepBeat = -1.0;
-    previousBlockEnd = -1.0;
+    nextStepCycle = 0;
+    clockBeat = -1.0;
+    driftBlocks = 0;
 }
@@ -1,23 +1,81 @@
 #pragma once
 
+#include "GrooveTemplate.h"
 #include <array>
+#include <cstdint>
 #include <vector>
 #include <functional>
 
 enum class StepDirection : int { Down = 0, Up = 1, Rest = 2 };
 
+class SongArrangement;
+
 class StepSequencer
 {
 public:
-    static constexpr int STEP_COUNT = 16;
-    static constexpr double SUBDIV_8TH  = 0.5;
-    static constexpr double SUBDIV_16TH = 0.25;
+    static constexpr int MAX_STEPS = 64;
+    static constexpr int DEFAULT_STEPS = 16;
+    static_assert (GrooveTemplate::MAX_STEPS == MAX_STEPS, "a groove step per pattern step");
+
+    // Step grids, indexed by the subdivision parameter
+    static constexpr int NUM_SUBDIVISIONS = 6;
+    static constexpr std::array<double, NUM_SUBDIVISIONS> SUBDIVISION_BEATS = {{
+        0.5,            // 8th
+        0.25,           // 16th
+        1.0 / 3.0,      // 8th triplet
+        1.0 / 6.0,      // 16th triplet
+        0.75,           // dotted 8th
+        0.375           // dotted 16th
+    }};
+
+    // Factory pattern: repeating High/Medium/Low accents
+    static constexpr std::array<float, MAX_STEPS> DEFAULT_STEP_VELOCITIES = {{
+        107, 0, 90, 90, 0, 90, 100, 90,  107, 0, 90, 90, 0, 90, 100, 90,
+        107, 0, 90, 90, 0, 90, 100, 90,  107, 0, 90, 90, 0, 90, 100, 90,
+        107, 0, 90, 90, 0, 90, 100, 90,  107, 0, 90, 90, 0, 90, 100, 90,
+        107, 0, 90, 90, 0, 90, 100, 90,  107, 0, 90, 90, 0, 90, 100, 90
+    }};
+
+    // One strum pattern, compiled into the onset of each step within a
+    // cycle (with the cycle length at onsets[numSteps])
+    struct Pattern
+    {
+        int numSteps = DEFAULT_STEPS;
+        int subdivisionIndex = 0;
+        std::array<float, MAX_STEPS> velocities = DEFAULT_STEP_VELOCITIES;
+        std::array<StepDirection, MAX_STEPS> directions {};   // alternating Down/Up
+        std::array<float, MAX_STEPS> lengths {};              // in grid steps
+        std::array<double, MAX_STEPS + 1> onsets {};
+
+        Pattern();
+
+        // Rebuilds onsets after numSteps, subdivisionIndex or lengths change
+        void compile();
+        double getCycleLength() const { return onsets[static_cast<size_t> (numSteps)]; }
+
+        // Step whose span contains an offset into the cycle
+        int findStep (double offset) const;
+    };
 
     StepSequencer();
 
-    // Step velocity management
+    // The pattern played wherever the song arrangement (if any) has no
+    // section.  Its shape is recompiled only when it actually changes.
     void setStepVelocity (int step, float velocity);
     float getStepVelocity (int step) const;
+    void setStepDirection (int step, StepDirection direction);
+    void setPattern (int numSteps, int subdivisionIndex);
+    void setStepLength (int step, float gridSteps);   // 1 = one grid step
+    int getNumSteps() const { return livePattern.numSteps; }
+
+    // Song mode: sections of the arrangement play their own patterns,
+    // anchored at the section start.  The arrangement must stay alive
+    // while set (nullptr = live pattern only).
+    void setArrangement (const SongArrangement* arrangement);
+
+    // Groove applied to every pattern played, `amount` 0-1.  Each pattern
+    // gets its own resolved table when it starts playing.
+    void setGroove (const GrooveTemplate& groove, float amount);
 
     // Transport-driven step scanning
     struct StepEvent
@@ -25,29 +83,84 @@ public:
         double beatPosition;
         int stepIndex;
         float velocity;
+        StepDirection direction;
+        float strumSpeedScale;   // from the groove
     };
 
-    // Scan for step events within a block, returns list of triggered steps
+    // Scan for step events within a block, returns list of triggered steps.
+    // Steps are scheduled from an internal clock that advances by exactly
+    // each block's length and is phase-locked to the host position, so
+    // jitter in the reported position neither doubles nor skips a step.
     std::vector<StepEvent> processBlock (double blockStartBeat,
                                           double blockEndBeat,
                                           bool isPlaying,
                                           bool isCycling,
                                           double cycleStart,
-                                          double cycleEnd,
-                                          int subdivisionIndex);
+                                          double cycleEnd);
 
     void reset();
     int getCurrentStep() const { return currentStep; }
 
+    // Step the pattern is in at a given beat, as it would have been
+    // reported at its onset (no scheduling side effects)
+    StepEvent getStepAt (double beat);
+    int getStepIndexAt (double beat) { return getStepAt (beat).stepIndex; }
+
 private:
-    std::array<float, STEP_COUNT> stepVelocities {};
+    Pattern livePattern;
+    bool patternDirty = true;
+    const SongArrangement* arrangement = nullptr;
+
+    // Stretch of the timeline one pattern plays over
+    struct Segment
+    {
+        const Pattern* pattern;
+        double anchorBeat;   // where the pattern's step 0 falls
+        double endBeat;
+    };
+    Segment segment { &livePattern, 0.0, 0.0 };
+    Segment findSegment (double beat) const;
+    double getMeanStepDuration() const { return segment.pattern->getCycleLength() / segment.pattern->numSteps; }
+
+    // The groove resolved against the segment's pattern: one read per step
+    struct GrooveStep
+    {
+        double offset = 0.0;   // in beats
+        float velocity = 1.0f;
+        float strumSpeed = 1.0f;
+    };
+    GrooveTemplate groove;
+    float grooveAmount = 0.0f;
+    std::array<GrooveStep, MAX_STEPS> grooveTable {};
+    const Pattern* groovePattern = nullptr;   // pattern grooveTable was resolved for
+    void resolveGroove();
+
     int currentStep = -1;
-    double nextStepBeat = -1.0;
-    double previousBlockEnd = -1.0;
+    double nextStepBeat = -1.0;   // with the step's groove offset
+    int64_t nextStepCycle = 0;   // pattern cycle nextStepBeat falls in
+
+    // Internal clock: where the next block should start (-1 = not locked)
+    double clockBeat = -1.0;
+    int driftBlocks = 0;        // consecutive blocks outside the lock window
 
     static constexpr int MAX_STEPS_PER_BLOCK = 32;
 
-    static double getStepDuration (int subdivisionIndex);
-    static double quantizeToStep (double beat, double stepDuration);
-    static int calculateStepIndex (double beat, double stepDuration);
+    // Host position error, in steps: within LOCK_WINDOW it is jitter and is
+    // smoothed away; beyond JUMP_THRESHOLD it is a seek and resyncs at once;
+    // in between it resyncs only if it persists for DRIFT_BLOCKS blocks
+    static constexpr double LOCK_WINDOW    = 0.25;
+    static constexpr double JUMP_THRESHOLD = 1.0;
+    static constexpr int DRIFT_BLOCKS      = 4;
+    static constexpr double PLL_GAIN       = 0.125;   // share of the error corrected per block
+
+    // Points nextStepBeat at the step containing `beat`, or at the one after
+    // it once `beat` is more than `lateness` of the way through that step
+    void seekToStep (double beat, double lateness);
+    void advanceStep();
+    double getNextStepGridBeat() const { return nextStepBeat - grooveTable[static_cast<size_t> (currentStep)].offset; }
+
+    // Reports the pending step, `beatShift` later, and schedules the next
+    void emitStep (std::vector<StepEvent>& events, double beatShift);
+
+    void resync (double beat);
 };
@@ -1,9 +1,19 @@
 #include "StrumEngine.h"
+#include <algorithm>
 #include <cmath>
 
-StrumEngine::StrumEngine()
-    : rng (std::random_device{}())
+float StrumEngine::humanizeNoise (double strumBeat, int slot, HumanizeDraw draw)
 {
+    auto tick = static_cast<uint64_t> (std::llround (strumBeat * 960.0));
+    auto stream = static_cast<uint64_t> (slot) * 4 + static_cast<uint64_t> (draw) + 1;
+
+    // SplitMix64 finaliser over the packed key
+    uint64_t x = tick * 0x9e3779b97f4a7c15ull ^ stream * 0xd1b54a32d192ed03ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    x ^= x >> 31;
+
+    return static_cast<float> (x >> 40) * (2.0f / 16777216.0f) - 1.0f;
 }
 
 int StrumEngine::clamp (int value, int minVal, int maxVal)
@@ -11,13 +21,57 @@ int StrumEngine::clamp (int value, int minVal, int maxVal)
     return std::min (maxVal, std::max (minVal, value));
 }
 
-std::vector<StrumNote> StrumEngine::generateStrum (const std::vector<int>& notesToStrum,
+uint32_t StrumEngine::slotMaskFor (const std::vector<StringPitch>& notes)
+{
+    uint32_t mask = 0;
+    for (auto& n : notes)
+    {
+        if (n.slot >= 0 && n.slot < MAX_SLOTS)
+            mask |= 1u << n.slot;
+    }
+    return mask;
+}
+
+std::vector<StringPitch> StrumEngine::getChangedNotes (const std::vector<StringPitch>& notes) const
+{
+    std::vector<StringPitch> changed;
+    for (auto& n : notes)
+    {
+        bool ringing = n.slot >= 0 && n.slot < MAX_SLOTS
+                    && (activeMask & (1u << n.slot)) != 0
+                    && slots[static_cast<size_t> (n.slot)].pitch == n.pitch;
+        if (! ringing)
+            changed.push_back (n);
+    }
+    return changed;
+}
+
+void StrumEngine::setSlot (int slot, const ActiveNote& note)
+{
+    if (slot < 0 || slot >= MAX_SLOTS)
+        return;
+
+    slots[static_cast<size_t> (slot)] = note.pitch >= 0 ? note : ActiveNote {};
+    if (note.pitch >= 0)
+        activeMask |= 1u << slot;
+    else
+        activeMask &= ~(1u << slot);
+}
+
+void StrumEngine::clearActiveNotes()
+{
+    slots.fill ({});
+    activeMask = 0;
+}
+
+std::vector<StrumNote> StrumEngine::generateStrum (const std::vector<StringPitch>& notesToStrum,
                                                     StepDirection direction,
                                                     float velocity,
                                                     float strumSpeedMs,
                                                     float humanizeAmount,
                                                     bool multiChannel,
-                                                    double tempo)
+                                                    double tempo,
+                                                    double strumBeat)
 {
     std::vector<StrumNote> result;
     if (notesToStrum.empty() || velocity <= 0.0f)
@@ -27,32 +81,36 @@ std::vector<StrumNote> StrumEngine::generateStrum (const std::vector<int>& notes
 
     bool isDownStrum = (direction == StepDirection::Down);
 
-    std::vector<int> ordered = notesToStrum;
+    std::vector<StringPitch> ordered = notesToStrum;
     if (! isDownStrum)
         std::reverse (ordered.begin(), ordered.end());
 
-    std::uniform_real_distribution<float> dist (-1.0f, 1.0f);
-
     // Global step timing offset: shift the entire strum slightly early/late (±15ms at full)
     double globalOffsetMs = 0.0;
     if (humanizeAmount > 0.0f)
     {
-        globalOffsetMs = dist (rng) * 15.0 * humanizeAmount;
+        globalOffsetMs = humanizeNoise (strumBeat, MAX_SLOTS, HumanizeDraw::StepOffset) * 15.0 * humanizeAmount;
         if (globalOffsetMs < 0.0) globalOffsetMs = 0.0; // only delay, never early
     }
 
-    std::vector<ActiveNote> newActiveNotes;
-
     for (size_t i = 0; i < ordered.size(); ++i)
     {
+        int slot = ordered[i].slot;
+        if (slot < 0 || slot >= MAX_SLOTS)
+            continue;
+
         StrumNote note;
-        note.pitch = ordered[i];
-        note.channel = multiChannel ? (static_cast<int> (i) % 6 + 1) : 1;
+        note.pitch = ordered[i].pitch;
+        note.slot = slot;
+        // Multi-channel follows the physical string, so an up-strum keeps
+        // each string on the same channel as a down-strum
+        note.channel = multiChannel ? (slot % 6 + 1) : 1;
 
         // Velocity with humanization (±30 at full)
         int velVariation = 0;
         if (humanizeAmount > 0.0f)
-            velVariation = static_cast<int> (std::round (dist (rng) * 30.0f * humanizeAmount));
+            velVariation = static_cast<int> (std::round (humanizeNoise (strumBeat, slot, HumanizeDraw::Velocity)
+                                                         * 30.0f * humanizeAmount));
 
         note.velocity = clamp (static_cast<int> (velocity) + velVariation, 1, 127);
 
@@ -62,17 +120,26 @@ std::vector<StrumNote> StrumEngine::generateStrum (const std::vector<int>& notes
         // Per-note timing humanization (±10ms at full)
         if (humanizeAmount > 0.0f && i > 0)
         {
-            delayMs += dist (rng) * 10.0 * humanizeAmount;
+            delayMs += humanizeNoise (strumBeat, slot, HumanizeDraw::Timing) * 10.0 * humanizeAmount;
             if (delayMs < 0.0) delayMs = 0.0;
         }
 
         // Convert ms to beat offset
         note.beatOffset = delayMs / msPerBeat;
 
+        // Re-striking a slot chokes whatever it was still sounding
+        auto& current = slots[static_cast<size_t> (slot)];
+        if ((activeMask & (1u << slot)) != 0)
+        {
+            note.chokePitch = current.pitch;
+            note.chokeChannel = current.channel;
+        }
+
+        current = { note.pitch, note.channel };
+        activeMask |= 1u << slot;
+
         result.push_back (note);
-        newActiveNotes.push_back ({ note.pitch, note.channel });
     }
 
-    activeNotes = std::move (newActiveNotes);
     return result;
 }
@@ -1,45 +1,154 @@
 #pragma once
 
-#include <juce_audio_basics/juce_audio_basics.h>
 #include "StepSequencer.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <vector>
-#include <random>
+
+// A pitch bound to the string (or, with voicing off, the voice) that plays it
+struct StringPitch
+{
+    int slot;
+    int pitch;
+
+    bool operator== (const StringPitch& other) const { return slot == other.slot && pitch == other.pitch; }
+    bool operator!= (const StringPitch& other) const { return ! (*this == other); }
+};
 
 struct StrumNote
 {
     int pitch;
     int velocity;
     int channel;
+    int slot;
     double beatOffset; // beat offset from strum trigger point
+
+    // Note this strike chokes on the same slot (chokePitch < 0 = slot was silent)
+    int chokePitch = -1;
+    int chokeChannel = 1;
 };
 
 class StrumEngine
 {
 public:
-    StrumEngine();
+    // Slots 0-5 are guitar strings (low E first).  With voicing off, held
+    // keyboard notes take slots in ascending pitch order.
+    static constexpr int MAX_SLOTS = 16;
 
     struct ActiveNote
     {
-        int pitch;
-        int channel;
+        int pitch = -1; // -1 = slot silent
+        int channel = 1;
     };
 
-    // Generate strum notes with beat-based offsets
-    std::vector<StrumNote> generateStrum (const std::vector<int>& notesToStrum,
+    // Generate strum notes with beat-based offsets.  Each slot owns at most
+    // one sounding note; re-striking a slot reports the note it chokes.
+    // Humanize offsets depend only on strumBeat (the strum's song position)
+    // and the string, so every playback, seek and bounce strums alike.
+    std::vector<StrumNote> generateStrum (const std::vector<StringPitch>& notesToStrum,
                                           StepDirection direction,
                                           float velocity,
                                           float strumSpeedMs,
                                           float humanizeAmount, // 0-1
                                           bool multiChannel,
-                                          double tempo);
+                                          double tempo,
+                                          double strumBeat);
+
+    bool hasActiveNotes() const { return activeMask != 0; }
+    uint32_t getActiveMask() const { return activeMask; }
+    const ActiveNote& getSlot (int slot) const { return slots[static_cast<size_t> (slot)]; }
+
+    static uint32_t slotMaskFor (const std::vector<StringPitch>& notes);
+
+    // Notes whose slot is not already sounding that exact pitch — the
+    // strings a chord change actually needs to re-strike
+    std::vector<StringPitch> getChangedNotes (const std::vector<StringPitch>& notes) const;
+
+    // Silence the given slots, calling onRelease (int slot, const ActiveNote&)
+    // for each one that was sounding.
+    template <typename Callback>
+    void releaseSlots (uint32_t mask, Callback&& onRelease)
+    {
+        mask &= activeMask;
+        activeMask &= ~mask;
+
+        for (int s = 0; mask != 0; ++s, mask >>= 1)
+        {
+            if ((mask & 1u) != 0)
+            {
+                auto& note = slots[static_cast<size_t> (s)];
+                onRelease (s, note);
+                note = {};
+            }
+        }
+    }
 
-    const std::vector<ActiveNote>& getActiveNotes() const { return activeNotes; }
-    void setActiveNotes (std::vector<ActiveNote> notes) { activeNotes = std::move (notes); }
-    void clearActiveNotes() { activeNotes.clear(); }
+    template <typename Callback>
+    void releaseAll (Callback&& onRelease) { releaseSlots (activeMask, onRelease); }
+
+    // Overrides what a slot is sounding, e.g. after its scheduled strike
+    // was withdrawn (pitch < 0 = silent)
+    void setSlot (int slot, const ActiveNote& note);
+
+    void clearActiveNotes();
+
+    // Withdraws scheduled strikes that have yet to sound (NoteOns after
+    // `after`) on the slots in slotMask from an event queue, together with
+    // the chokes they carried and any later NoteOffs on the slot, then hands
+    // each slot back the note it is really sounding.  Without this a stale
+    // choke could cut the next strike of the same pitch short.  Event needs
+    // slot, status, data1 and isNoteOn(); timeOf gives its time.  Only
+    // events from index `first` on are looked at, so a caller appending to a
+    // long history can pass where its unsounded events start.
+    template <typename Event, typename Time, typename TimeOf>
+    void withdrawStrikes (std::vector<Event>& events, uint32_t slotMask, Time after, TimeOf&& timeOf,
+                          size_t first = 0)
+    {
+        auto begin = events.begin() + static_cast<std::ptrdiff_t> (std::min (first, events.size()));
+
+        for (int slot = 0; slot < MAX_SLOTS; ++slot)
+        {
+            if ((slotMask & (1u << slot)) == 0)
+                continue;
+
+            bool found = false;
+            Time firstStrike {};
+            for (auto it = begin; it != events.end(); ++it)
+            {
+                const auto& e = *it;
+                if (e.slot == slot && e.isNoteOn() && timeOf (e) > after && (! found || timeOf (e) < firstStrike))
+                {
+                    firstStrike = timeOf (e);
+                    found = true;
+                }
+            }
+
+            if (! found)
+                continue;
+
+            // The first strike's choke names the note the string is sounding
+            ActiveNote sounding;
+            for (auto it = begin; it != events.end(); ++it)
+                if (it->slot == slot && ! it->isNoteOn() && timeOf (*it) == firstStrike)
+                    sounding = { it->data1, (it->status & 0x0f) + 1 };
+
+            events.erase (std::remove_if (begin, events.end(),
+                              [&] (const Event& e) { return e.slot == slot && timeOf (e) >= firstStrike; }),
+                          events.end());
+
+            setSlot (slot, sounding);
+        }
+    }
 
 private:
-    std::vector<ActiveNote> activeNotes;
-    std::mt19937 rng;
+    std::array<ActiveNote, MAX_SLOTS> slots {};
+    uint32_t activeMask = 0;
+
+    // Counter-based noise in [-1, 1): a hash of the strum's position on a
+    // 960 PPQ grid, the slot and which of its draws is wanted
+    enum class HumanizeDraw { StepOffset, Velocity, Timing };
+    static float humanizeNoise (double strumBeat, int slot, HumanizeDraw draw);
 
     static int clamp (int value, int minVal, int maxVal);
 };
@@ -0,0 +1,112 @@
+#include "TraceRecorder.h"
+
+TraceRecorder::TraceRecorder()
+    : juce::Thread ("Trace writer")
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    stopCapture();
+}
+
+const char* TraceRecorder::getMarkerName (TraceMarker marker)
+{
+    switch (marker)
+    {
+        case TraceMarker::ProcessBlock:      return "processBlock";
+        case TraceMarker::UpdateVoicedNotes: return "updateVoicedNotes";
+        case TraceMarker::FindBestPosition:  return "findBestPosition";
+        case TraceMarker::EmitPendingEvents: return "emitPendingEvents";
+        case TraceMarker::StepEvent:         return "step";
+        case TraceMarker::ChordChange:       return "chordChange";
+    }
+
+    return "unknown";
+}
+
+void TraceRecorder::record (const TraceEvent& event) noexcept
+{
+    if (! capturing.load (std::memory_order_relaxed))
+        return;
+
+    if (! ring.push (event))
+        droppedEvents.fetch_add (1, std::memory_order_relaxed);
+}
+
+bool TraceRecorder::startCapture (const juce::File& file)
+{
+    stopCapture();
+
+    file.deleteFile();
+    auto newStream = std::make_unique<juce::FileOutputStream> (file);
+    if (! newStream->openedOk())
+        return false;
+
+    // Anything left over from a previous capture
+    TraceEvent stale;
+    while (ring.pop (stale)) {}
+
+    stream = std::move (newStream);
+    stream->writeText ("{\"traceEvents\":[\n", false, false, nullptr);
+    startTicks = juce::Time::getHighResolutionTicks();
+    firstEvent = true;
+    droppedEvents.store (0, std::memory_order_relaxed);
+
+    capturing.store (true, std::memory_order_release);
+    startThread();
+    return true;
+}
+
+void TraceRecorder::stopCapture()
+{
+    if (stream == nullptr)
+        return;
+
+    capturing.store (false, std::memory_order_release);
+    stopThread (1000);
+
+    writePendingEvents();
+    stream->writeText ("\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":"
+                           + juce::String (droppedEvents.load (std::memory_order_relaxed)) + "}}\n",
+                       false, false, nullptr);
+    stream->flush();
+    stream.reset();
+}
+
+void TraceRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        writePendingEvents();
+        wait (20);
+    }
+}
+
+void TraceRecorder::writePendingEvents()
+{
+    TraceEvent event;
+    while (ring.pop (event))
+    {
+        auto micros = juce::Time::highResolutionTicksToSeconds (event.ticks - startTicks) * 1.0e6;
+
+        juce::String json;
+        json << (firstEvent ? "" : ",\n")
+             << "{\"name\":\"" << getMarkerName (event.marker) << "\",\"ph\":\"" << juce::String::charToString (event.phase)
+             << "\",\"ts\":" << juce::String (micros, 3) << ",\"pid\":1,\"tid\":1";
+
+        if (event.phase == 'X')
+            json << ",\"dur\":" << juce::String (juce::Time::highResolutionTicksToSeconds (event.duration) * 1.0e6, 3);
+        else
+            json << ",\"s\":\"t\"";
+
+        json << ",\"args\":{\"value\":" << event.value;
+        if (event.beat >= 0.0)
+            json << ",\"beat\":" << juce::String (event.beat, 4);
+        json << "}";
+
+        json << "}";
+        stream->writeText (json, false, false, nullptr);
+        firstEvent = false;
+    }
+}
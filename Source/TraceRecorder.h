@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "SpscFifo.h"
+
+// Audio-thread sections and moments that can appear in a trace
+enum class TraceMarker : uint8_t
+{
+    ProcessBlock,
+    UpdateVoicedNotes,
+    FindBestPosition,
+    EmitPendingEvents,
+    StepEvent,
+    ChordChange
+};
+
+// Captures timed sections and instant markers from the audio thread into a preallocated
+// lock-free ring and streams them to a Chrome trace JSON file (loadable in
+// chrome://tracing or Perfetto) from a background thread.
+class TraceRecorder : private juce::Thread
+{
+public:
+    TraceRecorder();
+    ~TraceRecorder() override;
+
+    // Message thread
+    bool startCapture (const juce::File& file);
+    void stopCapture();
+    bool isCapturing() const { return capturing.load (std::memory_order_relaxed); }
+
+    // Audio thread: no-ops unless a capture is running
+    void instant (TraceMarker marker, double beat, int value) noexcept
+    {
+        record ({ juce::Time::getHighResolutionTicks(), 0, beat, value, marker, 'i' });
+    }
+
+    // Times a scope as one complete event.  Only scopes that start while a
+    // capture is running are timed, so starting or stopping a capture part
+    // way through a block never leaves half a section in the trace
+    class Scope
+    {
+    public:
+        Scope (TraceRecorder& r, TraceMarker m, double b = -1.0, int v = 0) noexcept
+            : recorder (r), marker (m), beat (b), value (v),
+              startTicks (r.isCapturing() ? juce::Time::getHighResolutionTicks() : 0) {}
+
+        ~Scope()
+        {
+            if (startTicks != 0)
+                recorder.record ({ startTicks, juce::Time::getHighResolutionTicks() - startTicks,
+                                   beat, value, marker, 'X' });
+        }
+
+    private:
+        TraceRecorder& recorder;
+        TraceMarker marker;
+        double beat;
+        int value;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+private:
+    struct TraceEvent
+    {
+        juce::int64 ticks;      // high-resolution counter
+        juce::int64 duration;   // in ticks, 'X' only
+        double beat;         // transport position, < 0 = none
+        int32_t value;
+        TraceMarker marker;
+        char phase;             // 'X' or 'i'
+    };
+
+    void record (const TraceEvent& event) noexcept;
+    void run() override;
+    void writePendingEvents();
+
+    static const char* getMarkerName (TraceMarker marker);
+
+    std::atomic<bool> capturing { false };
+    std::atomic<uint32_t> droppedEvents { 0 };
+    SpscFifo<TraceEvent, 32768> ring;
+
+    // Owned by the writer thread while a capture is running
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::int64 startTicks = 0;
+    bool firstEvent = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TraceRecorder)
+};
@@ -5,6 +5,7 @@
 ControlPanelComponent::ControlPanelComponent (juce::AudioProcessorValueTreeState& a,
                                                 GuitarStrumSequencerProcessor& processor)
     : apvts (a),
+      processorRef (processor),
       fretboardComp (processor)
 {
     addAndMakeVisible (fretboardComp);
@@ -18,6 +19,18 @@ ControlPanelComponent::ControlPanelComponent (juce::AudioProcessorValueTreeState
     humanizeSlider.setRange (0, 100, 1);
     humanizeAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (apvts, "humanize", humanizeSlider);
 
+    // Groove
+    setupComboBox (grooveBox, grooveLabel, "Groove", { "Off", "Swing", "Laid Back", "Push", "File" });
+    grooveAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (apvts, "groove", grooveBox);
+
+    grooveAmountSlider.setSliderStyle (juce::Slider::LinearBar);
+    grooveAmountSlider.setTextValueSuffix ("%");
+    addAndMakeVisible (grooveAmountSlider);
+    grooveAmountAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (apvts, "grooveAmount", grooveAmountSlider);
+
+    grooveLoadButton.onClick = [this] { chooseGrooveFile(); };
+    addAndMakeVisible (grooveLoadButton);
+
     // Voicing toggle
     voicingToggle.setButtonText ("Enable Guitar Voicing");
     addAndMakeVisible (voicingToggle);
@@ -71,6 +84,20 @@ ControlPanelComponent::ControlPanelComponent (juce::AudioProcessorValueTreeState
 
 ControlPanelComponent::~ControlPanelComponent() = default;
 
+void ControlPanelComponent::chooseGrooveFile()
+{
+    grooveChooser = std::make_unique<juce::FileChooser> ("Load a groove template", juce::File(), "*.json;*.mid;*.midi");
+    grooveChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [this] (const juce::FileChooser& chooser)
+        {
+            auto file = chooser.getResult();
+            juce::String error;
+            if (file != juce::File() && ! processorRef.loadGrooveFile (file, error))
+                juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon,
+                                                        "Groove not loaded", file.getFileName() + ": " + error);
+        });
+}
+
 void ControlPanelComponent::setupSlider (juce::Slider& slider, juce::Label& label,
                                           const juce::String& text, const juce::String& suffix)
 {
@@ -135,8 +162,19 @@ void ControlPanelComponent::resized()
     humanizeSlider.setBounds (leftArea.getX() + labelWidth, startY + rowHeight + 4,
                               leftArea.getWidth() - labelWidth, rowHeight);
 
-    // Fretboard diagram below humanize
-    int fretboardY = startY + (rowHeight + 4) * 2;
+    // Groove: preset, amount and file picker on one row
+    int grooveY = startY + (rowHeight + 4) * 2;
+    auto grooveRow = juce::Rectangle<int> (leftArea.getX() + labelWidth, grooveY,
+                                           leftArea.getWidth() - labelWidth, rowHeight);
+    grooveLabel.setBounds (leftArea.getX(), grooveY, labelWidth, rowHeight);
+    grooveLoadButton.setBounds (grooveRow.removeFromRight (50).reduced (0, 2));
+    grooveRow.removeFromRight (6);
+    grooveAmountSlider.setBounds (grooveRow.removeFromRight (60).reduced (0, 4));
+    grooveRow.removeFromRight (6);
+    grooveBox.setBounds (grooveRow);
+
+    // Fretboard diagram below the groove row
+    int fretboardY = startY + (rowHeight + 4) * 3;
     int fretboardHeight = bounds.getHeight() - fretboardY;
     if (fretboardHeight > 20)
         fretboardComp.setBounds (leftArea.getX(), fretboardY,
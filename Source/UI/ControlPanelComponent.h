@@ -16,8 +16,11 @@ public:
     void paint (juce::Graphics& g) override;
     void resized() override;
 
+    void refresh() { fretboardComp.refresh(); }
+
 private:
     juce::AudioProcessorValueTreeState& apvts;
+    GuitarStrumSequencerProcessor& processorRef;
 
     // Strum controls
     juce::Slider strumSpeedSlider;
@@ -25,6 +28,14 @@ private:
     juce::Label strumSpeedLabel;
     juce::Label humanizeLabel;
 
+    // Groove: preset or loaded template, and how much of it to apply
+    juce::ComboBox grooveBox;
+    juce::Slider grooveAmountSlider;
+    juce::TextButton grooveLoadButton { "Load" };
+    juce::Label grooveLabel;
+    std::unique_ptr<juce::FileChooser> grooveChooser;
+    void chooseGrooveFile();
+
     // Voicing controls
     juce::ToggleButton voicingToggle;
     juce::ComboBox tuningBox;
@@ -48,6 +59,8 @@ private:
     // Attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> strumSpeedAttach;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> humanizeAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> grooveAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> grooveAmountAttach;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> voicingAttach;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> tuningAttach;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> capoAttach;
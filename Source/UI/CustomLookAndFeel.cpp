@@ -18,11 +18,39 @@ CustomLookAndFeel::CustomLookAndFeel()
     setColour (juce::ToggleButton::tickColourId, accent);
 }
 
-void CustomLookAndFeel::drawRotarySlider (juce::Graphics& g, int x, int y, int width, int height,
-                                           float sliderPosProportional, float rotaryStartAngle,
-                                           float rotaryEndAngle, juce::Slider&)
+template <typename Renderer>
+const juce::Image& CustomLookAndFeel::getCachedImage (juce::Graphics& g, const RenderCacheKey& key,
+                                                      Renderer&& render)
 {
-    auto bounds = juce::Rectangle<int> (x, y, width, height).toFloat().reduced (4.0f);
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != renderCacheScale || renderCache.size() >= MAX_CACHED_IMAGES)
+    {
+        renderCache.clear();
+        renderCacheScale = scale;
+    }
+
+    auto it = renderCache.find (key);
+    if (it != renderCache.end())
+        return it->second;
+
+    juce::Image image (juce::Image::ARGB,
+                       std::max (1, juce::roundToInt (key.width * scale)),
+                       std::max (1, juce::roundToInt (key.height * scale)),
+                       true);
+    {
+        juce::Graphics ig (image);
+        ig.addTransform (juce::AffineTransform::scale (scale));
+        render (ig);
+    }
+
+    return renderCache.emplace (key, image).first->second;
+}
+
+void CustomLookAndFeel::renderKnob (juce::Graphics& g, float width, float height,
+                                    float sliderPosProportional, float rotaryStartAngle,
+                                    float rotaryEndAngle)
+{
+    auto bounds = juce::Rectangle<float> (0.0f, 0.0f, width, height).reduced (4.0f);
     auto radius = std::min (bounds.getWidth(), bounds.getHeight()) / 2.0f;
     auto centreX = bounds.getCentreX();
     auto centreY = bounds.getCentreY();
@@ -50,6 +78,27 @@ void CustomLookAndFeel::drawRotarySlider (juce::Graphics& g, int x, int y, int w
     g.fillPath (thumb, juce::AffineTransform::rotation (angle).translated (centreX, centreY));
 }
 
+void CustomLookAndFeel::drawRotarySlider (juce::Graphics& g, int x, int y, int width, int height,
+                                           float sliderPosProportional, float rotaryStartAngle,
+                                           float rotaryEndAngle, juce::Slider&)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    int bucket = juce::roundToInt (std::clamp (sliderPosProportional, 0.0f, 1.0f) * (VALUE_BUCKETS - 1));
+    RenderCacheKey key { CachedShape::Knob, width, height, bucket, 0, rotaryStartAngle, rotaryEndAngle };
+
+    auto& image = getCachedImage (g, key, [&] (juce::Graphics& ig)
+    {
+        renderKnob (ig, static_cast<float> (width), static_cast<float> (height),
+                    static_cast<float> (bucket) / (VALUE_BUCKETS - 1),
+                    rotaryStartAngle, rotaryEndAngle);
+    });
+
+    g.drawImageTransformed (image, juce::AffineTransform::scale (1.0f / renderCacheScale)
+                                       .translated (static_cast<float> (x), static_cast<float> (y)));
+}
+
 void CustomLookAndFeel::drawLinearSlider (juce::Graphics& g, int x, int y, int width, int height,
                                            float sliderPos, float /*minSliderPos*/, float /*maxSliderPos*/,
                                            juce::Slider::SliderStyle style, juce::Slider&)
@@ -112,24 +161,20 @@ void CustomLookAndFeel::drawComboBox (juce::Graphics& g, int width, int height,
     g.fillPath (arrow);
 }
 
-void CustomLookAndFeel::drawToggleButton (juce::Graphics& g, juce::ToggleButton& button,
-                                           bool shouldDrawButtonAsHighlighted,
-                                           bool /*shouldDrawButtonAsDown*/)
+void CustomLookAndFeel::renderToggleBox (juce::Graphics& g, float boxSize, bool isOn, bool isHighlighted)
 {
-    auto bounds = button.getLocalBounds().toFloat();
-    auto boxSize = 18.0f;
-    auto boxBounds = juce::Rectangle<float> (4.0f, (bounds.getHeight() - boxSize) / 2.0f, boxSize, boxSize);
+    auto boxBounds = juce::Rectangle<float> (0.0f, 0.0f, boxSize, boxSize);
 
-    g.setColour (button.getToggleState() ? accent : sliderTrack);
+    g.setColour (isOn ? accent : sliderTrack);
     g.fillRoundedRectangle (boxBounds, 3.0f);
 
-    if (shouldDrawButtonAsHighlighted)
+    if (isHighlighted)
     {
         g.setColour (juce::Colours::white.withAlpha (0.1f));
         g.fillRoundedRectangle (boxBounds, 3.0f);
     }
 
-    if (button.getToggleState())
+    if (isOn)
     {
         g.setColour (juce::Colours::white);
         juce::Path tick;
@@ -138,6 +183,28 @@ void CustomLookAndFeel::drawToggleButton (juce::Graphics& g, juce::ToggleButton&
         tick.lineTo (boxBounds.getRight() - 4, boxBounds.getY() + 5);
         g.strokePath (tick, juce::PathStrokeType (2.0f));
     }
+}
+
+void CustomLookAndFeel::drawToggleButton (juce::Graphics& g, juce::ToggleButton& button,
+                                           bool shouldDrawButtonAsHighlighted,
+                                           bool /*shouldDrawButtonAsDown*/)
+{
+    auto bounds = button.getLocalBounds().toFloat();
+    auto boxSize = 18.0f;
+    auto boxBounds = juce::Rectangle<float> (4.0f, (bounds.getHeight() - boxSize) / 2.0f, boxSize, boxSize);
+
+    bool isOn = button.getToggleState();
+    int state = (isOn ? 1 : 0) | (shouldDrawButtonAsHighlighted ? 2 : 0);
+    RenderCacheKey key { CachedShape::ToggleBox, static_cast<int> (boxSize), static_cast<int> (boxSize),
+                         0, state, 0.0f, 0.0f };
+
+    auto& image = getCachedImage (g, key, [&] (juce::Graphics& ig)
+    {
+        renderToggleBox (ig, boxSize, isOn, shouldDrawButtonAsHighlighted);
+    });
+
+    g.drawImageTransformed (image, juce::AffineTransform::scale (1.0f / renderCacheScale)
+                                       .translated (boxBounds.getX(), boxBounds.getY()));
 
     g.setColour (button.findColour (juce::ToggleButton::textColourId));
     g.drawText (button.getButtonText(),
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <map>
+#include <tuple>
 
 class CustomLookAndFeel : public juce::LookAndFeel_V4
 {
@@ -37,4 +39,37 @@ public:
 
     juce::Font getComboBoxFont (juce::ComboBox&) override;
     juce::Font getLabelFont (juce::Label&) override;
+
+private:
+    // Pre-rasterised knob and toggle-box images, keyed by size, value
+    // bucket and colour state; flushed when the display scale changes
+    enum class CachedShape { Knob, ToggleBox };
+
+    struct RenderCacheKey
+    {
+        CachedShape shape;
+        int width, height;
+        int valueBucket;
+        int state;
+        float startAngle, endAngle;
+
+        bool operator< (const RenderCacheKey& o) const
+        {
+            return std::tie (shape, width, height, valueBucket, state, startAngle, endAngle)
+                 < std::tie (o.shape, o.width, o.height, o.valueBucket, o.state, o.startAngle, o.endAngle);
+        }
+    };
+
+    static constexpr int VALUE_BUCKETS = 256;
+    static constexpr size_t MAX_CACHED_IMAGES = 512;
+
+    std::map<RenderCacheKey, juce::Image> renderCache;
+    float renderCacheScale = 0.0f;
+
+    template <typename Renderer>
+    const juce::Image& getCachedImage (juce::Graphics& g, const RenderCacheKey& key, Renderer&& render);
+
+    static void renderKnob (juce::Graphics& g, float width, float height, float sliderPosProportional,
+                            float rotaryStartAngle, float rotaryEndAngle);
+    static void renderToggleBox (juce::Graphics& g, float boxSize, bool isOn, bool isHighlighted);
 };
@@ -0,0 +1,280 @@
+#include "DiagnosticsComponent.h"
+#include "CustomLookAndFeel.h"
+#include "../PluginProcessor.h"
+
+namespace
+{
+    // Bar chart of counts; bins from highlightFrom onwards are drawn as warnings
+    template <size_t N>
+    void drawHistogram (juce::Graphics& g, juce::Rectangle<int> area, const juce::String& title,
+                        const std::array<uint32_t, N>& bins, const juce::String& leftLabel,
+                        const juce::String& rightLabel, size_t highlightFrom)
+    {
+        const int labelHeight = 16;
+
+        g.setColour (CustomLookAndFeel::textSecondary);
+        g.drawText (title, area.removeFromTop (labelHeight), juce::Justification::centredLeft);
+
+        auto labels = area.removeFromBottom (labelHeight);
+        g.drawText (leftLabel, labels, juce::Justification::centredLeft);
+        g.drawText (rightLabel, labels, juce::Justification::centredRight);
+
+        uint32_t tallest = 1;
+        for (auto count : bins)
+            tallest = juce::jmax (tallest, count);
+
+        float binWidth = static_cast<float> (area.getWidth()) / static_cast<float> (N);
+        for (size_t b = 0; b < N; ++b)
+        {
+            float h = static_cast<float> (area.getHeight()) * bins[b] / tallest;
+            g.setColour (b >= highlightFrom ? CustomLookAndFeel::accent : CustomLookAndFeel::stepActive);
+            g.fillRect (area.getX() + b * binWidth + 1.0f, static_cast<float> (area.getBottom()) - h,
+                        binWidth - 2.0f, h);
+        }
+    }
+}
+
+DiagnosticsComponent::DiagnosticsComponent (GuitarStrumSequencerProcessor& processor)
+    : processorRef (processor)
+{
+    setOpaque (true);
+
+    traceButton.onClick = [this] { toggleTrace(); };
+    addAndMakeVisible (traceButton);
+
+    blackBoxToggle.setToggleState (processorRef.getBlackBoxRecorder().isEnabled(), juce::dontSendNotification);
+    blackBoxToggle.onClick = [this]
+    {
+        processorRef.getBlackBoxRecorder().setEnabled (blackBoxToggle.getToggleState());
+        dumpButton.setEnabled (blackBoxToggle.getToggleState());
+    };
+    addAndMakeVisible (blackBoxToggle);
+
+    dumpButton.setEnabled (blackBoxToggle.getToggleState());
+    dumpButton.onClick = [this] { dumpBlackBox(); };
+    addAndMakeVisible (dumpButton);
+}
+
+DiagnosticsComponent::~DiagnosticsComponent()
+{
+    processorRef.getTraceRecorder().stopCapture();
+    processorRef.diagnosticsEnabled.store (false, std::memory_order_relaxed);
+}
+
+void DiagnosticsComponent::visibilityChanged()
+{
+    bool showing = isVisible();
+    processorRef.diagnosticsEnabled.store (showing, std::memory_order_relaxed);
+
+    // Drop anything collected during an earlier session
+    if (showing)
+        resetHistory();
+}
+
+void DiagnosticsComponent::resized()
+{
+    auto row = getLocalBounds().reduced (12, 8).removeFromTop (20);
+    traceButton.setBounds (row.removeFromRight (110));
+    row.removeFromRight (8);
+    dumpButton.setBounds (row.removeFromRight (60));
+    blackBoxToggle.setBounds (row.removeFromRight (90));
+}
+
+void DiagnosticsComponent::dumpBlackBox()
+{
+    auto file = juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+                    .getNonexistentChildFile ("GuitarStrumBlackBox", ".gsbb");
+
+    statusText = processorRef.dumpBlackBox (file) ? "Saved " + file.getFullPathName()
+                                                  : "Could not write " + file.getFullPathName();
+    repaint();
+}
+
+void DiagnosticsComponent::toggleTrace()
+{
+    auto& tracer = processorRef.getTraceRecorder();
+
+    if (tracer.isCapturing())
+    {
+        tracer.stopCapture();
+        traceButton.setButtonText ("Record trace");
+    }
+    else
+    {
+        lastTraceFile = juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+                            .getNonexistentChildFile ("GuitarStrumTrace", ".json");
+
+        if (tracer.startCapture (lastTraceFile))
+            traceButton.setButtonText ("Stop trace");
+    }
+
+    statusText = tracer.isCapturing() ? "Tracing to " + lastTraceFile.getFileName()
+                                      : "Saved " + lastTraceFile.getFullPathName();
+
+    repaint();
+}
+
+void DiagnosticsComponent::resetHistory()
+{
+    BlockDiagnostics stale;
+    while (processorRef.popBlockDiagnostics (stale)) {}
+
+    historyCount = 0;
+    historyWrite = 0;
+    loadHistogram.fill (0);
+    timingHistogram.fill (0);
+    lateEvents = clampedEvents = droppedEvents = 0;
+}
+
+void DiagnosticsComponent::addBlock (const BlockDiagnostics& block)
+{
+    auto slot = static_cast<size_t> (historyWrite);
+
+    // The oldest block leaves the histograms as it leaves the window
+    if (historyCount == historySize)
+    {
+        const auto& oldest = history[slot];
+        if (historyLoadBins[slot] >= 0)
+            --loadHistogram[static_cast<size_t> (historyLoadBins[slot])];
+
+        for (size_t b = 0; b < timingHistogram.size(); ++b)
+            timingHistogram[b] -= oldest.timingErrorHistogram[b];
+
+        lateEvents -= oldest.lateEvents;
+        clampedEvents -= oldest.clampedEvents;
+        droppedEvents -= oldest.droppedEvents;
+    }
+
+    history[slot] = block;
+    historyLoadBins[slot] = -1;
+    historyWrite = (historyWrite + 1) % historySize;
+    historyCount = juce::jmin (historyCount + 1, historySize);
+
+    auto sampleRate = processorRef.getSampleRate();
+    if (sampleRate > 0.0 && block.numSamples > 0)
+    {
+        double budgetMicros = block.numSamples * 1.0e6 / sampleRate;
+        double load = block.processMicros / budgetMicros;
+        int bin = juce::jlimit (0, histogramBins - 1, static_cast<int> (load * (histogramBins - 1)));
+        ++loadHistogram[static_cast<size_t> (bin)];
+        historyLoadBins[slot] = static_cast<int8_t> (bin);
+    }
+
+    for (size_t b = 0; b < timingHistogram.size(); ++b)
+        timingHistogram[b] += block.timingErrorHistogram[b];
+
+    lateEvents += block.lateEvents;
+    clampedEvents += block.clampedEvents;
+    droppedEvents += block.droppedEvents;
+}
+
+void DiagnosticsComponent::refresh()
+{
+    if (! isVisible())
+        return;
+
+    bool changed = false;
+    BlockDiagnostics block;
+    while (processorRef.popBlockDiagnostics (block))
+    {
+        addBlock (block);
+        changed = true;
+    }
+
+    if (changed)
+        repaint();
+}
+
+void DiagnosticsComponent::paint (juce::Graphics& g)
+{
+    g.fillAll (CustomLookAndFeel::bgDark);
+
+    auto bounds = getLocalBounds().reduced (12, 8);
+
+    g.setColour (CustomLookAndFeel::textPrimary);
+    g.setFont (juce::Font (14.0f).boldened());
+    auto title = bounds.removeFromTop (20);
+    g.drawText ("DIAGNOSTICS", title, juce::Justification::centredLeft);
+
+    if (statusText.isNotEmpty())
+    {
+        g.setFont (juce::Font (11.0f));
+        g.setColour (CustomLookAndFeel::textSecondary);
+        g.drawText (statusText, title.withTrimmedLeft (110).withTrimmedRight (280),
+                    juce::Justification::centredRight);
+    }
+
+    // Mean / max of each counter over the rolling window
+    struct Counter { const char* name; float BlockDiagnostics::* f; uint32_t BlockDiagnostics::* u; };
+    static const Counter counters[] = {
+        { "Block time (us)", &BlockDiagnostics::processMicros, nullptr },
+        { "Voicer calls",    nullptr, &BlockDiagnostics::voicerCalls },
+        { "Cache hits",      nullptr, &BlockDiagnostics::cacheHits },
+        { "Cache misses",    nullptr, &BlockDiagnostics::cacheMisses },
+        { "Search nodes",    nullptr, &BlockDiagnostics::searchNodes },
+        { "Pending events",  nullptr, &BlockDiagnostics::pendingDepth },
+        { "Events emitted",  nullptr, &BlockDiagnostics::eventsEmitted },
+        { "Re-triggers",     nullptr, &BlockDiagnostics::retriggers },
+    };
+
+    auto table = bounds.removeFromLeft (bounds.getWidth() / 2);
+    const int rowHeight = 18;
+
+    g.setFont (juce::Font (12.0f));
+    g.setColour (CustomLookAndFeel::textSecondary);
+    auto header = table.removeFromTop (rowHeight);
+    header.removeFromLeft (120);
+    g.drawText ("mean", header.removeFromLeft (70), juce::Justification::centredRight);
+    g.drawText ("max", header.removeFromLeft (70), juce::Justification::centredRight);
+
+    int idleBlocks = 0;
+    float maxTimingError = 0.0f;
+    for (int i = 0; i < historyCount; ++i)
+    {
+        const auto& block = history[static_cast<size_t> (i)];
+        if (block.idle)
+            ++idleBlocks;
+        maxTimingError = juce::jmax (maxTimingError, block.maxTimingError);
+    }
+
+    for (const auto& counter : counters)
+    {
+        double sum = 0.0, peak = 0.0;
+        for (int i = 0; i < historyCount; ++i)
+        {
+            const auto& block = history[static_cast<size_t> (i)];
+            double value = counter.f != nullptr ? static_cast<double> (block.*(counter.f))
+                                                : static_cast<double> (block.*(counter.u));
+            sum += value;
+            peak = juce::jmax (peak, value);
+        }
+        double mean = historyCount > 0 ? sum / historyCount : 0.0;
+
+        auto row = table.removeFromTop (rowHeight);
+        g.setColour (CustomLookAndFeel::textSecondary);
+        g.drawText (counter.name, row.removeFromLeft (120), juce::Justification::centredLeft);
+        g.setColour (CustomLookAndFeel::textPrimary);
+        g.drawText (juce::String (mean, 1), row.removeFromLeft (70), juce::Justification::centredRight);
+        g.drawText (juce::String (peak, 1), row.removeFromLeft (70), juce::Justification::centredRight);
+    }
+
+    auto footer = table.removeFromTop (rowHeight);
+    g.setColour (CustomLookAndFeel::textSecondary);
+    g.drawText ("Idle blocks: " + juce::String (idleBlocks) + " / " + juce::String (historyCount)
+                    + "   Chord: " + juce::String (processorRef.getUITelemetry().chordName.data()),
+                footer, juce::Justification::centredLeft);
+
+    // Block-time histogram, as a share of each block's real-time budget,
+    // above the scheduled-versus-emitted timing error of every event
+    auto plots = bounds.reduced (8, 0);
+    auto loadPlot = plots.removeFromTop (plots.getHeight() / 2).withTrimmedBottom (6);
+
+    drawHistogram (g, loadPlot, "Block load (last " + juce::String (historyCount) + " blocks)",
+                   loadHistogram, "0%", ">100%", histogramBins - 1);
+
+    drawHistogram (g, plots, "Timing error: max " + juce::String (maxTimingError, 2) + " smp, "
+                                 + juce::String (static_cast<juce::int64> (lateEvents)) + " late, "
+                                 + juce::String (static_cast<juce::int64> (clampedEvents)) + " clamped, "
+                                 + juce::String (static_cast<juce::int64> (droppedEvents)) + " dropped",
+                   timingHistogram, "<0.5 smp", ">256 smp", 1);
+}
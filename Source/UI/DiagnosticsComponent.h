@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../Diagnostics.h"
+
+class GuitarStrumSequencerProcessor;
+
+// Live view of the per-block hot-path counters.  Hidden by default; while
+// visible it switches the processor's diagnostics on and drains them on vblank.
+class DiagnosticsComponent : public juce::Component
+{
+public:
+    explicit DiagnosticsComponent (GuitarStrumSequencerProcessor& processor);
+    ~DiagnosticsComponent() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+    // Called on vblank by the editor: drains new blocks and repaints
+    void refresh();
+
+private:
+    GuitarStrumSequencerProcessor& processorRef;
+
+    // Rolling window of the most recent blocks
+    static constexpr int historySize = 256;
+    std::array<BlockDiagnostics, historySize> history {};
+    int historyCount = 0;
+    int historyWrite = 0;
+
+    // Block time as a fraction of the block's real-time budget, in 5% bins
+    // (the last bin collects everything over budget), over the same window;
+    // each block's bin is kept so it can come out again (-1 = none)
+    static constexpr int histogramBins = 21;
+    std::array<uint32_t, histogramBins> loadHistogram {};
+    std::array<int8_t, historySize> historyLoadBins {};
+
+    // Scheduled-versus-emitted sample error of every event in the window
+    std::array<uint32_t, TIMING_ERROR_BINS> timingHistogram {};
+    uint64_t lateEvents = 0, clampedEvents = 0, droppedEvents = 0;
+
+    // Starts / stops a Chrome trace capture to the user's documents folder
+    juce::TextButton traceButton { "Record trace" };
+    juce::File lastTraceFile;
+    void toggleTrace();
+
+    // Black-box recorder: keep recent blocks, dump them for offline replay
+    juce::ToggleButton blackBoxToggle { "Black box" };
+    juce::TextButton dumpButton { "Dump" };
+    juce::String statusText;
+    void dumpBlackBox();
+
+    void addBlock (const BlockDiagnostics& block);
+    void resetHistory();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiagnosticsComponent)
+};
@@ -0,0 +1,248 @@
+#include "ExportComponent.h"
+#include "CustomLookAndFeel.h"
+#include "../PluginProcessor.h"
+#include "../MidiClipWriter.h"
+
+namespace
+{
+    const int barChoices[] = { 4, 8, 16, 32, 64 };
+    constexpr double beatsPerBar = 4.0;
+    constexpr double captureGrid = 0.25;   // captured changes snap to 16ths
+
+    // Close voicing from C3 up; the voicer re-spreads it across the strings
+    std::vector<int> chordNotes (const std::vector<int>& pitchClasses, int rootPitchClass)
+    {
+        std::vector<int> notes;
+        int root = 48 + rootPitchClass;
+
+        for (int pc : pitchClasses)
+            notes.push_back (root + ((pc - rootPitchClass + 12) % 12));
+
+        std::sort (notes.begin(), notes.end());
+        return notes;
+    }
+}
+
+ExportComponent::ExportComponent (GuitarStrumSequencerProcessor& processor)
+    : processorRef (processor)
+{
+    setOpaque (true);
+
+    chordsEditor.setText ("C G Am F", false);
+    addAndMakeVisible (chordsEditor);
+
+    for (int i = 0; i < static_cast<int> (std::size (barChoices)); ++i)
+        barsBox.addItem (juce::String (barChoices[i]) + " bars", i + 1);
+    barsBox.setSelectedId (2, juce::dontSendNotification);
+    addAndMakeVisible (barsBox);
+
+    capturedToggle.onClick = [this] { chordsEditor.setEnabled (! capturedToggle.getToggleState()); };
+    addAndMakeVisible (capturedToggle);
+
+    renderButton.onClick = [this] { startRender(); };
+    addAndMakeVisible (renderButton);
+}
+
+ExportComponent::~ExportComponent() = default;
+
+void ExportComponent::resized()
+{
+    auto bounds = getLocalBounds().reduced (12, 8);
+    bounds.removeFromTop (28);
+
+    auto row = bounds.removeFromTop (24);
+    chordsEditor.setBounds (row);
+    bounds.removeFromTop (8);
+
+    row = bounds.removeFromTop (24);
+    barsBox.setBounds (row.removeFromLeft (100));
+    row.removeFromLeft (8);
+    capturedToggle.setBounds (row.removeFromLeft (170));
+    renderButton.setBounds (row.removeFromRight (90));
+    bounds.removeFromTop (12);
+
+    clipArea = bounds.removeFromTop (48);
+}
+
+int ExportComponent::getNumBars() const
+{
+    int index = juce::jlimit (0, static_cast<int> (std::size (barChoices)) - 1, barsBox.getSelectedId() - 1);
+    return barChoices[index];
+}
+
+void ExportComponent::refresh()
+{
+    ChordCapture capture;
+    while (processorRef.popChordCapture (capture))
+    {
+        // The transport jumped back: what came before no longer lines up
+        if (! captured.empty() && capture.beat < captured.back().beat)
+            captured.clear();
+
+        captured.push_back (capture);
+        if (captured.size() > maxCaptured)
+            captured.pop_front();
+    }
+}
+
+bool ExportComponent::buildTypedChords (std::vector<ChordChange>& chords, double endBeat)
+{
+    auto names = juce::StringArray::fromTokens (chordsEditor.getText(), false);
+    names.removeEmptyStrings();
+
+    if (names.size() == 0)
+    {
+        statusText = "Type a chord sequence, e.g. C G Am F";
+        return false;
+    }
+
+    std::vector<std::vector<int>> parsed;
+    for (const auto& name : names)
+    {
+        std::vector<int> pitchClasses;
+        int root = 0;
+        if (! GuitarVoicer::parseChordName (name.toStdString(), pitchClasses, root))
+        {
+            statusText = "Unknown chord \"" + name + "\"";
+            return false;
+        }
+        parsed.push_back (chordNotes (pitchClasses, root));
+    }
+
+    int bar = 0;
+    for (double beat = 0.0; beat < endBeat; beat += beatsPerBar, ++bar)
+        chords.push_back ({ beat, parsed[static_cast<size_t> (bar) % parsed.size()] });
+
+    return true;
+}
+
+bool ExportComponent::buildCapturedChords (std::vector<ChordChange>& chords, double endBeat) const
+{
+    if (captured.empty())
+        return false;
+
+    // The last N bars, ending at the bar line after the latest change
+    double windowEnd = std::ceil ((captured.back().beat + captureGrid) / beatsPerBar) * beatsPerBar;
+    double windowStart = windowEnd - endBeat;
+
+    for (const auto& capture : captured)
+    {
+        double beat = std::round ((capture.beat - windowStart) / captureGrid) * captureGrid;
+        std::vector<int> notes (capture.notes.begin(), capture.notes.begin() + capture.numNotes);
+
+        // Changes before the window only set the chord held at its start
+        beat = juce::jmax (0.0, beat);
+        if (! chords.empty() && chords.back().beat >= beat)
+            chords.back().notes = std::move (notes);
+        else
+            chords.push_back ({ beat, std::move (notes) });
+    }
+
+    return true;
+}
+
+void ExportComponent::startRender()
+{
+    if (rendering)
+        return;
+
+    double endBeat = getNumBars() * beatsPerBar;
+    std::vector<ChordChange> chords;
+
+    if (capturedToggle.getToggleState())
+    {
+        if (! buildCapturedChords (chords, endBeat))
+            statusText = "Nothing captured yet: play along with the transport running";
+    }
+    else
+    {
+        buildTypedChords (chords, endBeat);
+    }
+
+    if (chords.empty())
+    {
+        repaint();
+        return;
+    }
+
+    // The render gets copies of everything, so the editor stays free to change
+    auto settings = processorRef.getStrumSettings();
+    settings.offlineQuality = true;
+    double bpm = processorRef.getUITelemetry().bpm;
+    auto file = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                    .getNonexistentChildFile ("GuitarStrum", ".mid");
+
+    rendering = true;
+    renderButton.setEnabled (false);
+    statusText = "Rendering...";
+    repaint();
+
+    juce::Thread::launch ([safeThis = juce::Component::SafePointer<ExportComponent> (this),
+                           settings, chords = std::move (chords), bpm, endBeat, file]
+    {
+        OfflineRenderer renderer;
+        auto events = renderer.render (settings, chords, { { 0.0, bpm } }, endBeat);
+
+        bool ok = false;
+        if (auto out = file.createOutputStream())
+            ok = MidiClipWriter::write (*out, events, endBeat, 960, MidiClipWriter::makeConductor (bpm));
+
+        juce::MessageManager::callAsync ([safeThis, file, ok]
+        {
+            if (safeThis != nullptr)
+                safeThis->renderFinished (file, ok);
+        });
+    });
+}
+
+void ExportComponent::renderFinished (const juce::File& file, bool ok)
+{
+    rendering = false;
+    renderButton.setEnabled (true);
+
+    if (ok)
+    {
+        clipFile = file;
+        statusText = juce::String (getNumBars()) + " bars rendered";
+    }
+    else
+    {
+        statusText = "Could not write " + file.getFullPathName();
+    }
+
+    repaint();
+}
+
+void ExportComponent::mouseDrag (const juce::MouseEvent& event)
+{
+    if (clipFile.existsAsFile() && clipArea.contains (event.getMouseDownPosition()))
+        juce::DragAndDropContainer::performExternalDragDropOfFiles (juce::StringArray (clipFile.getFullPathName()),
+                                                                    false, this);
+}
+
+void ExportComponent::paint (juce::Graphics& g)
+{
+    g.fillAll (CustomLookAndFeel::bgDark);
+
+    auto bounds = getLocalBounds().reduced (12, 8);
+    auto title = bounds.removeFromTop (20);
+
+    g.setColour (CustomLookAndFeel::textPrimary);
+    g.setFont (juce::Font (14.0f).boldened());
+    g.drawText ("EXPORT MIDI", title, juce::Justification::centredLeft);
+
+    g.setFont (juce::Font (11.0f));
+    g.setColour (CustomLookAndFeel::textSecondary);
+    g.drawText (statusText, title.withTrimmedLeft (110), juce::Justification::centredRight);
+
+    // Drag tile for the last rendered clip
+    bool hasClip = clipFile.existsAsFile();
+    g.setColour (hasClip ? CustomLookAndFeel::bgLight : CustomLookAndFeel::bgMedium);
+    g.fillRoundedRectangle (clipArea.toFloat(), 4.0f);
+
+    g.setColour (hasClip ? CustomLookAndFeel::textPrimary : CustomLookAndFeel::textSecondary);
+    g.setFont (juce::Font (12.0f));
+    g.drawText (hasClip ? "Drag " + clipFile.getFileName() + " into your DAW"
+                        : "Render a clip, then drag it from here",
+                clipArea, juce::Justification::centred);
+}
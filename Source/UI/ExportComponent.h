@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../UITelemetry.h"
+#include "../OfflineRenderer.h"
+#include <deque>
+
+class GuitarStrumSequencerProcessor;
+
+// Renders N bars of strum MIDI with the current settings — from a typed
+// chord sequence or from the chords played while the transport ran — on a
+// background thread, then offers the clip as a file to drag into the host.
+class ExportComponent : public juce::Component
+{
+public:
+    explicit ExportComponent (GuitarStrumSequencerProcessor& processor);
+    ~ExportComponent() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+    void mouseDrag (const juce::MouseEvent& event) override;
+
+    // Called on vblank by the editor: logs chord changes even while hidden
+    void refresh();
+
+private:
+    GuitarStrumSequencerProcessor& processorRef;
+
+    juce::TextEditor chordsEditor;   // one chord per bar, cycled
+    juce::ComboBox barsBox;
+    juce::ToggleButton capturedToggle { "Use captured chords" };
+    juce::TextButton renderButton { "Render" };
+
+    juce::String statusText;
+    juce::File clipFile;             // last rendered clip, dragged out from clipArea
+    juce::Rectangle<int> clipArea;
+    bool rendering = false;
+
+    // Chord changes drained from the processor, oldest first
+    static constexpr size_t maxCaptured = 4096;
+    std::deque<ChordCapture> captured;
+
+    int getNumBars() const;
+    bool buildTypedChords (std::vector<ChordChange>& chords, double endBeat);
+    bool buildCapturedChords (std::vector<ChordChange>& chords, double endBeat) const;
+
+    void startRender();
+    void renderFinished (const juce::File& file, bool ok);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ExportComponent)
+};
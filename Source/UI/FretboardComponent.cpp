@@ -1,115 +1,195 @@
 #include "FretboardComponent.h"
 #include "CustomLookAndFeel.h"
 #include "../PluginProcessor.h"
-#include "../GuitarVoicer.h"
 
 FretboardComponent::FretboardComponent (GuitarStrumSequencerProcessor& processor)
     : processorRef (processor)
 {
-    startTimerHz (10);
+    auto& apvts = processorRef.getAPVTS();
+    voicingEnabledParam = apvts.getRawParameterValue ("guitarVoicing");
+    capoParam = apvts.getRawParameterValue ("capo");
+
+    updateDisplayState();
 }
 
-FretboardComponent::~FretboardComponent()
+FretboardComponent::~FretboardComponent() = default;
+
+void FretboardComponent::refresh()
 {
-    stopTimer();
+    // Only repaint when the telemetry or a displayed parameter changed
+    if (updateDisplayState())
+        repaint();
+
+    animateStrikes();
 }
 
-void FretboardComponent::timerCallback()
+juce::Rectangle<int> FretboardComponent::getStringRowBounds (int stringIndex) const
 {
-    repaint();
+    const float fretboardHeight = static_cast<float> (getHeight()) - topMargin - bottomMargin;
+    const float stringSpacing = fretboardHeight / (numStrings - 1);
+    int displayRow = numStrings - 1 - stringIndex;  // flip: low E at bottom
+    int y = static_cast<int> (topMargin + displayRow * stringSpacing);
+
+    return { static_cast<int> (leftMargin + oxWidth), y - 4, getWidth(), 9 };
 }
 
-void FretboardComponent::paint (juce::Graphics& g)
+float FretboardComponent::getStrikeLevel (int stringIndex, double nowMs) const
 {
-    auto bounds = getLocalBounds().toFloat();
-    if (bounds.getWidth() < 10 || bounds.getHeight() < 10)
-        return;
+    auto elapsed = nowMs - strikeTimeMs[static_cast<size_t> (stringIndex)];
+    if (elapsed < 0.0)
+        return 0.0f;   // struck later in this strum
 
-    // Check if voicing is enabled
-    auto& apvts = processorRef.getAPVTS();
-    bool voicingEnabled = apvts.getRawParameterValue ("guitarVoicing")->load() >= 0.5f;
+    return strikeVelocity[static_cast<size_t> (stringIndex)]
+         * static_cast<float> (std::exp (-elapsed / strikeDecayMs));
+}
 
-    bool hasData = voicingEnabled && processorRef.isVoicingForUIValid();
-    VoicingResult voicing;
-    if (hasData)
-        voicing = processorRef.getVoicingForUI();
+void FretboardComponent::animateStrikes()
+{
+    auto nowMs = juce::Time::getMillisecondCounterHiRes();
+    auto sampleRate = processorRef.getSampleRate();
+
+    // Strikes drained together are spread out by their sample distance, so
+    // the strum plays back across the strings instead of lighting at once
+    StringStrike strike;
+    juce::int64 firstSample = -1;
+    while (processorRef.popStringStrike (strike))
+    {
+        if (firstSample < 0)
+            firstSample = strike.samplePosition;
+
+        auto s = static_cast<size_t> (strike.stringIndex);
+        if (s >= static_cast<size_t> (numStrings))
+            continue;
+
+        strikeTimeMs[s] = nowMs;
+        if (sampleRate > 0.0)
+            strikeTimeMs[s] += static_cast<double> (strike.samplePosition - firstSample) * 1000.0 / sampleRate;
+        strikeVelocity[s] = strike.velocity / 127.0f;
+        stringAnimating[s] = true;
+    }
 
-    int capo = static_cast<int> (apvts.getRawParameterValue ("capo")->load());
+    for (int s = 0; s < numStrings; ++s)
+    {
+        if (! stringAnimating[static_cast<size_t> (s)])
+            continue;
 
-    // Horizontal layout: strings are horizontal, frets are vertical
-    // Top = high e, Bottom = low E (guitar player's perspective)
-    constexpr int numStrings = 6;
-    constexpr int maxFrets = 7;
+        // Keep repainting the row until the glow has faded (plus one final clear)
+        bool pending = strikeTimeMs[static_cast<size_t> (s)] > nowMs;
+        if (! pending && getStrikeLevel (s, nowMs) < 0.01f)
+            stringAnimating[static_cast<size_t> (s)] = false;
 
-    const float leftMargin = 18.0f;   // string name labels
-    const float oxWidth = 14.0f;      // O/X indicator column
-    const float rightMargin = 6.0f;
-    const float topMargin = 14.0f;    // fret number labels
-    const float bottomMargin = 4.0f;
+        if (hasData)
+            repaint (getStringRowBounds (s));
+    }
+}
 
-    const float fretboardLeft = leftMargin + oxWidth;
-    const float fretboardWidth = bounds.getWidth() - fretboardLeft - rightMargin;
-    const float fretboardHeight = bounds.getHeight() - topMargin - bottomMargin;
-    const float stringSpacing = fretboardHeight / (numStrings - 1);
+bool FretboardComponent::updateDisplayState()
+{
+    const auto& telemetry = processorRef.getUITelemetry();
+    bool voicingEnabled = voicingEnabledParam->load() >= 0.5f;
+    bool newHasData = voicingEnabled && telemetry.voicingValid;
+    int newCapo = static_cast<int> (capoParam->load());
+
+    if (telemetry.version == lastTelemetryVersion && newHasData == hasData && newCapo == capo)
+        return false;
+
+    lastTelemetryVersion = telemetry.version;
+    hasData = newHasData;
+    capo = newCapo;
+    voicing = telemetry.voicing;
 
     // Determine fret range to display (voicing frets are relative to capo)
-    int startFret = 0;
-    int numFrets = maxFrets;
+    startFret = 0;
+    numFrets = maxFrets;
+    fingers.fill (0);
 
-    if (hasData)
-    {
-        int minFret = 99, maxFret = 0;
-        bool hasFrettedNote = false;
-        bool hasOpenString = false;
+    if (! hasData)
+        return true;
+
+    int minFret = 99, maxFret = 0;
+    bool hasFrettedNote = false;
+    bool hasOpenString = false;
 
-        for (int s = 0; s < numStrings; ++s)
+    for (int s = 0; s < numStrings; ++s)
+    {
+        auto& sn = voicing.voicing[static_cast<size_t> (s)];
+        if (sn.pitch >= 0)
         {
-            auto& sn = voicing.voicing[static_cast<size_t> (s)];
-            if (sn.pitch >= 0)
+            if (sn.fret == 0)
+                hasOpenString = true;
+            else if (sn.fret > 0)
             {
-                if (sn.fret == 0)
-                    hasOpenString = true;
-                else if (sn.fret > 0)
-                {
-                    hasFrettedNote = true;
-                    minFret = std::min (minFret, sn.fret);
-                    maxFret = std::max (maxFret, sn.fret);
-                }
+                hasFrettedNote = true;
+                minFret = std::min (minFret, sn.fret);
+                maxFret = std::max (maxFret, sn.fret);
             }
         }
+    }
 
-        if (hasFrettedNote)
+    if (hasFrettedNote)
+    {
+        // Adaptive fret count: show just enough frets to frame the notes
+        int effectiveMin = hasOpenString ? 0 : minFret;
+        int range = maxFret - effectiveMin;
+        numFrets = std::clamp (range + 2, 4, maxFrets);
+
+        if (hasOpenString)
+        {
+            // Must show nut for open strings
+            startFret = 0;
+            // Ensure all fretted notes are visible
+            if (maxFret > numFrets)
+                numFrets = std::min (maxFret + 1, maxFrets);
+        }
+        else
         {
-            // Adaptive fret count: show just enough frets to frame the notes
-            int effectiveMin = hasOpenString ? 0 : minFret;
-            int range = maxFret - effectiveMin;
-            numFrets = std::clamp (range + 2, 4, maxFrets);
+            // Center the fretted notes within the display
+            int span = maxFret - minFret + 1;
+            int padding = (numFrets - span) / 2;
+            startFret = std::max (0, minFret - padding - 1);
 
-            if (hasOpenString)
-            {
-                // Must show nut for open strings
-                startFret = 0;
-                // Ensure all fretted notes are visible
-                if (maxFret > numFrets)
-                    numFrets = std::min (maxFret + 1, maxFrets);
-            }
-            else
-            {
-                // Center the fretted notes within the display
-                int span = maxFret - minFret + 1;
-                int padding = (numFrets - span) / 2;
-                startFret = std::max (0, minFret - padding - 1);
+            if (maxFret - startFret >= numFrets)
+                startFret = maxFret - numFrets + 1;
+        }
+    }
 
-                if (maxFret - startFret >= numFrets)
-                    startFret = maxFret - numFrets + 1;
-            }
+    // Build finger assignment: group fretted notes by fret, assign fingers 1-4
+    // in ascending fret order
+    std::vector<int> uniqueFrets;
+    for (int vi = 0; vi < numStrings; ++vi)
+    {
+        int fret = voicing.voicing[static_cast<size_t> (vi)].fret;
+        if (voicing.voicing[static_cast<size_t> (vi)].pitch >= 0 && fret > 0)
+        {
+            if (std::find (uniqueFrets.begin(), uniqueFrets.end(), fret) == uniqueFrets.end())
+                uniqueFrets.push_back (fret);
         }
     }
+    std::sort (uniqueFrets.begin(), uniqueFrets.end());
 
-    bool showNut = (startFret == 0);
+    for (int vi = 0; vi < numStrings; ++vi)
+    {
+        auto& sn = voicing.voicing[static_cast<size_t> (vi)];
+        if (sn.pitch < 0 || sn.fret <= 0)
+            continue;
+
+        auto it = std::find (uniqueFrets.begin(), uniqueFrets.end(), sn.fret);
+        fingers[static_cast<size_t> (vi)] = static_cast<int> (it - uniqueFrets.begin()) + 1;
+    }
 
+    return true;
+}
+
+void FretboardComponent::renderBackground (juce::Graphics& g, float width, float height) const
+{
+    const float fretboardLeft = leftMargin + oxWidth;
+    const float fretboardWidth = width - fretboardLeft - rightMargin;
+    const float fretboardHeight = height - topMargin - bottomMargin;
+    const float stringSpacing = fretboardHeight / (numStrings - 1);
     const float fretSpacing = fretboardWidth / numFrets;
 
+    bool showNut = (startFret == 0);
+
     // Draw fret bars (vertical lines)
     g.setColour (CustomLookAndFeel::textSecondary.withAlpha (0.5f));
     for (int f = 0; f <= numFrets; ++f)
@@ -190,34 +270,61 @@ void FretboardComponent::paint (juce::Graphics& g)
                     28, static_cast<int> (topMargin),
                     juce::Justification::centred);
     }
+}
 
-    if (! hasData)
+void FretboardComponent::paint (juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    if (bounds.getWidth() < 10 || bounds.getHeight() < 10)
         return;
 
-    // Build finger assignment: group fretted notes by fret, assign fingers 1-4
-    // in ascending fret order
-    std::vector<int> uniqueFrets;
-    for (int vi = 0; vi < numStrings; ++vi)
+    // Re-render the static grid only when its size or fret window changed
+    BackgroundKey key;
+    key.width = getWidth();
+    key.height = getHeight();
+    key.scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    key.capo = capo;
+    key.startFret = startFret;
+    key.numFrets = numFrets;
+
+    if (! (key == backgroundKey) || ! background.isValid())
     {
-        int fret = voicing.voicing[static_cast<size_t> (vi)].fret;
-        if (voicing.voicing[static_cast<size_t> (vi)].pitch >= 0 && fret > 0)
-        {
-            if (std::find (uniqueFrets.begin(), uniqueFrets.end(), fret) == uniqueFrets.end())
-                uniqueFrets.push_back (fret);
-        }
+        background = juce::Image (juce::Image::ARGB,
+                                  std::max (1, juce::roundToInt (key.width * key.scale)),
+                                  std::max (1, juce::roundToInt (key.height * key.scale)),
+                                  true);
+        juce::Graphics bg (background);
+        bg.addTransform (juce::AffineTransform::scale (key.scale));
+        renderBackground (bg, bounds.getWidth(), bounds.getHeight());
+        backgroundKey = key;
     }
-    std::sort (uniqueFrets.begin(), uniqueFrets.end());
 
-    // Map fret → finger number (1-based)
-    auto getFingerForFret = [&] (int fret) -> int
+    g.drawImageTransformed (background, juce::AffineTransform::scale (1.0f / key.scale));
+
+    if (! hasData)
+        return;
+
+    const float fretboardLeft = leftMargin + oxWidth;
+    const float fretboardWidth = bounds.getWidth() - fretboardLeft - rightMargin;
+    const float fretboardHeight = bounds.getHeight() - topMargin - bottomMargin;
+    const float stringSpacing = fretboardHeight / (numStrings - 1);
+    const float fretSpacing = fretboardWidth / numFrets;
+
+    // Glow on strings that were just struck
+    auto nowMs = juce::Time::getMillisecondCounterHiRes();
+    for (int vi = 0; vi < numStrings; ++vi)
     {
-        for (size_t i = 0; i < uniqueFrets.size(); ++i)
-        {
-            if (uniqueFrets[i] == fret)
-                return static_cast<int> (i) + 1;
-        }
-        return 1;
-    };
+        float level = getStrikeLevel (vi, nowMs);
+        if (level < 0.01f)
+            continue;
+
+        int displayRow = numStrings - 1 - vi;  // flip: low E at bottom
+        float y = topMargin + displayRow * stringSpacing;
+        float thickness = 1.0f + 3.0f * level;
+
+        g.setColour (CustomLookAndFeel::stepActive.withAlpha (level));
+        g.fillRect (fretboardLeft, y - thickness * 0.5f, fretboardWidth, thickness);
+    }
 
     // Draw finger dots, O/X indicators, and finger numbers
     auto boldFont = juce::FontOptions (12.0f);
@@ -263,7 +370,7 @@ void FretboardComponent::paint (juce::Graphics& g)
                                dotRadius * 2.0f, dotRadius * 2.0f);
 
                 // Finger number inside dot
-                int finger = getFingerForFret (sn.fret);
+                int finger = fingers[static_cast<size_t> (vi)];
                 if (finger >= 1 && finger <= 4)
                 {
                     g.setColour (CustomLookAndFeel::bgDark);
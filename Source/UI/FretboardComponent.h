@@ -1,11 +1,11 @@
 #pragma once
 
 #include <juce_gui_basics/juce_gui_basics.h>
+#include "../GuitarVoicer.h"
 
 class GuitarStrumSequencerProcessor;
 
-class FretboardComponent : public juce::Component,
-                           private juce::Timer
+class FretboardComponent : public juce::Component
 {
 public:
     explicit FretboardComponent (GuitarStrumSequencerProcessor& processor);
@@ -13,10 +13,63 @@ public:
 
     void paint (juce::Graphics& g) override;
 
+    // Called on vblank by the editor: repaints only if something changed
+    void refresh();
+
 private:
-    void timerCallback() override;
+    // Re-reads telemetry/parameters; returns true if the display changed
+    bool updateDisplayState();
+    void renderBackground (juce::Graphics& g, float width, float height) const;
+
+    // Drains struck strings from the audio thread and repaints their rows
+    void animateStrikes();
+    float getStrikeLevel (int stringIndex, double nowMs) const;
+    juce::Rectangle<int> getStringRowBounds (int stringIndex) const;
 
     GuitarStrumSequencerProcessor& processorRef;
+    std::atomic<float>* voicingEnabledParam = nullptr;
+    std::atomic<float>* capoParam = nullptr;
+
+    // Horizontal layout: strings are horizontal, frets are vertical
+    static constexpr int numStrings = 6;
+    static constexpr int maxFrets = 7;
+
+    static constexpr float leftMargin = 18.0f;   // string name labels
+    static constexpr float oxWidth = 14.0f;      // O/X indicator column
+    static constexpr float rightMargin = 6.0f;
+    static constexpr float topMargin = 14.0f;    // fret number labels
+    static constexpr float bottomMargin = 4.0f;
+
+    // What is currently displayed, derived from the telemetry frame
+    juce::uint64 lastTelemetryVersion = 0;
+    bool hasData = false;
+    VoicingResult voicing;
+    int capo = 0;
+    int startFret = 0;
+    int numFrets = maxFrets;
+    std::array<int, numStrings> fingers {};   // finger number per string, 0 = none
+
+    // Strum animation: each struck string glows and fades out
+    static constexpr double strikeDecayMs = 250.0;
+    std::array<double, numStrings> strikeTimeMs {};
+    std::array<float, numStrings> strikeVelocity {};
+    std::array<bool, numStrings> stringAnimating {};
+
+    // Static grid (frets, strings, labels, capo) cached per size and fret window
+    struct BackgroundKey
+    {
+        int width = 0, height = 0;
+        float scale = 0.0f;
+        int capo = -1, startFret = -1, numFrets = -1;
+
+        bool operator== (const BackgroundKey& o) const
+        {
+            return width == o.width && height == o.height && scale == o.scale
+                && capo == o.capo && startFret == o.startFret && numFrets == o.numFrets;
+        }
+    };
+    BackgroundKey backgroundKey;
+    juce::Image background;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FretboardComponent)
 };
@@ -0,0 +1,132 @@
+#include "SongComponent.h"
+#include "CustomLookAndFeel.h"
+
+SongComponent::SongComponent (SongMode& mode)
+    : songMode (mode)
+{
+    setOpaque (true);
+
+    storeButton.onClick = [this]
+    {
+        songMode.storePattern (selectedSlot);
+        statusText = "Stored the live pattern in " + SongMode::getSlotName (selectedSlot);
+        repaint();
+    };
+    addAndMakeVisible (storeButton);
+
+    recallButton.onClick = [this]
+    {
+        songMode.recallPattern (selectedSlot);
+        statusText = "Recalled " + SongMode::getSlotName (selectedSlot) + " into the live pattern";
+        repaint();
+    };
+    addAndMakeVisible (recallButton);
+
+    enabledToggle.onClick = [this] { songMode.setEnabled (enabledToggle.getToggleState()); };
+    addAndMakeVisible (enabledToggle);
+
+    arrangementEditor.setMultiLine (true);
+    arrangementEditor.setReturnKeyStartsNewLine (true);
+    arrangementEditor.setTextToShowWhenEmpty ("A 1-8, B 9-16", CustomLookAndFeel::textSecondary);
+    addAndMakeVisible (arrangementEditor);
+
+    applyButton.onClick = [this]
+    {
+        juce::String error;
+        statusText = songMode.setArrangement (arrangementEditor.getText(), error) ? "Arrangement applied" : error;
+        repaint();
+    };
+    addAndMakeVisible (applyButton);
+
+    loadFromState();
+}
+
+SongComponent::~SongComponent() = default;
+
+void SongComponent::loadFromState()
+{
+    enabledToggle.setToggleState (songMode.isEnabled(), juce::dontSendNotification);
+    arrangementEditor.setText (songMode.getArrangementText(), false);
+    recallButton.setEnabled (songMode.hasPattern (selectedSlot));
+}
+
+void SongComponent::visibilityChanged()
+{
+    // The host may have loaded another state while the overlay was hidden
+    if (isVisible())
+        loadFromState();
+}
+
+void SongComponent::resized()
+{
+    auto bounds = getLocalBounds().reduced (12, 8);
+    bounds.removeFromTop (28);
+
+    auto row = bounds.removeFromTop (28);
+    recallButton.setBounds (row.removeFromRight (70));
+    row.removeFromRight (6);
+    storeButton.setBounds (row.removeFromRight (70));
+    row.removeFromRight (12);
+
+    int slotWidth = row.getWidth() / SongMode::NUM_SLOTS;
+    for (auto& area : slotAreas)
+        area = row.removeFromLeft (slotWidth).reduced (2, 0);
+    bounds.removeFromTop (10);
+
+    row = bounds.removeFromTop (24);
+    enabledToggle.setBounds (row.removeFromLeft (120));
+    applyButton.setBounds (row.removeFromRight (70));
+    bounds.removeFromTop (6);
+
+    arrangementEditor.setBounds (bounds);
+}
+
+void SongComponent::mouseDown (const juce::MouseEvent& event)
+{
+    for (int slot = 0; slot < SongMode::NUM_SLOTS; ++slot)
+    {
+        if (slotAreas[static_cast<size_t> (slot)].contains (event.getPosition()))
+        {
+            selectedSlot = slot;
+            recallButton.setEnabled (songMode.hasPattern (slot));
+            repaint();
+            return;
+        }
+    }
+}
+
+void SongComponent::paint (juce::Graphics& g)
+{
+    g.fillAll (CustomLookAndFeel::bgDark);
+
+    auto bounds = getLocalBounds().reduced (12, 8);
+    auto title = bounds.removeFromTop (20);
+
+    g.setColour (CustomLookAndFeel::textPrimary);
+    g.setFont (juce::Font (14.0f).boldened());
+    g.drawText ("SONG MODE", title, juce::Justification::centredLeft);
+
+    g.setFont (juce::Font (11.0f));
+    g.setColour (CustomLookAndFeel::textSecondary);
+    g.drawText (statusText, title.withTrimmedLeft (110), juce::Justification::centredRight);
+
+    // Slot tiles: filled once a pattern is stored, outlined when selected
+    g.setFont (juce::Font (13.0f).boldened());
+    for (int slot = 0; slot < SongMode::NUM_SLOTS; ++slot)
+    {
+        auto area = slotAreas[static_cast<size_t> (slot)].toFloat();
+        bool stored = songMode.hasPattern (slot);
+
+        g.setColour (stored ? CustomLookAndFeel::bgLight : CustomLookAndFeel::bgMedium);
+        g.fillRoundedRectangle (area, 4.0f);
+
+        if (slot == selectedSlot)
+        {
+            g.setColour (CustomLookAndFeel::accent);
+            g.drawRoundedRectangle (area.reduced (0.5f), 4.0f, 1.5f);
+        }
+
+        g.setColour (stored ? CustomLookAndFeel::textPrimary : CustomLookAndFeel::textSecondary);
+        g.drawText (SongMode::getSlotName (slot), area, juce::Justification::centred);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../SongMode.h"
+
+// Song mode editor: store the live pattern into slots A-H, recall them, and
+// type the bar ranges each slot plays over.
+class SongComponent : public juce::Component
+{
+public:
+    explicit SongComponent (SongMode& songMode);
+    ~SongComponent() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+    void mouseDown (const juce::MouseEvent& event) override;
+    void visibilityChanged() override;
+
+private:
+    SongMode& songMode;
+
+    std::array<juce::Rectangle<int>, SongMode::NUM_SLOTS> slotAreas;
+    int selectedSlot = 0;
+
+    juce::TextButton storeButton { "Store" };
+    juce::TextButton recallButton { "Recall" };
+    juce::ToggleButton enabledToggle { "Song mode" };
+    juce::TextEditor arrangementEditor;
+    juce::TextButton applyButton { "Apply" };
+
+    juce::String statusText;
+
+    // Pulls the arrangement and switch back from the plugin state
+    void loadFromState();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SongComponent)
+};
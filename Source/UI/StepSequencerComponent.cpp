@@ -5,18 +5,22 @@ StepSequencerComponent::StepSequencerComponent (juce::AudioProcessorValueTreeSta
                                                   std::atomic<int>& currentStepRef)
     : apvts (a), currentStep (currentStepRef)
 {
-    startTimerHz (30);
-}
+    for (int i = 0; i < StepSequencer::MAX_STEPS; ++i)
+    {
+        stepVelocityParams[static_cast<size_t> (i)] = apvts.getRawParameterValue ("step" + juce::String (i + 1));
+        stepDirectionParams[static_cast<size_t> (i)] = apvts.getRawParameterValue ("dir" + juce::String (i + 1));
+    }
 
-StepSequencerComponent::~StepSequencerComponent()
-{
-    stopTimer();
+    patternLengthParam = apvts.getRawParameterValue ("patternLength");
+    numSteps = static_cast<int> (patternLengthParam->load());
 }
 
+StepSequencerComponent::~StepSequencerComponent() = default;
+
 juce::Rectangle<int> StepSequencerComponent::getBarBounds (int step) const
 {
     auto area = getLocalBounds().reduced (4, 20);
-    auto barWidth = area.getWidth() / StepSequencer::STEP_COUNT;
+    auto barWidth = area.getWidth() / numSteps;
     auto gap = 2;
 
     return juce::Rectangle<int> (
@@ -26,13 +30,22 @@ juce::Rectangle<int> StepSequencerComponent::getBarBounds (int step) const
         area.getHeight());
 }
 
+juce::Rectangle<int> StepSequencerComponent::getStepColumnBounds (int step) const
+{
+    // Bar, highlight border and direction arrow of one step
+    auto area = getLocalBounds().reduced (4, 0);
+    auto barWidth = area.getWidth() / numSteps;
+
+    return { area.getX() + step * barWidth, 0, barWidth, getHeight() };
+}
+
 int StepSequencerComponent::getStepAtPosition (juce::Point<int> pos) const
 {
     auto area = getLocalBounds().reduced (4, 20);
-    auto barWidth = area.getWidth() / StepSequencer::STEP_COUNT;
+    auto barWidth = area.getWidth() / numSteps;
 
     int step = (pos.getX() - area.getX()) / barWidth;
-    return std::clamp (step, 0, StepSequencer::STEP_COUNT - 1);
+    return std::clamp (step, 0, numSteps - 1);
 }
 
 void StepSequencerComponent::setStepFromMouse (const juce::MouseEvent& event)
@@ -50,7 +63,7 @@ void StepSequencerComponent::setStepFromMouse (const juce::MouseEvent& event)
     if (auto* param = apvts.getParameter (paramId))
         param->setValueNotifyingHost (param->convertTo0to1 (velocity));
 
-    repaint();
+    repaint (getStepColumnBounds (step));
 }
 
 void StepSequencerComponent::mouseDown (const juce::MouseEvent& event)
@@ -60,14 +73,13 @@ void StepSequencerComponent::mouseDown (const juce::MouseEvent& event)
     {
         // Click in arrow area — cycle direction: Down → Up → Rest → Down
         int step = getStepAtPosition (event.getPosition());
-        auto dirParamId = "dir" + juce::String (step + 1);
-        if (auto* param = apvts.getParameter (dirParamId))
+        if (auto* param = apvts.getParameter ("dir" + juce::String (step + 1)))
         {
-            int current = static_cast<int> (apvts.getRawParameterValue (dirParamId)->load());
+            int current = static_cast<int> (stepDirectionParams[static_cast<size_t> (step)]->load());
             int next = (current + 1) % 3;
             param->setValueNotifyingHost (param->convertTo0to1 (static_cast<float> (next)));
         }
-        repaint();
+        repaint (getStepColumnBounds (step));
         return;
     }
 
@@ -83,14 +95,29 @@ void StepSequencerComponent::mouseDrag (const juce::MouseEvent& event)
     setStepFromMouse (event);
 }
 
-void StepSequencerComponent::timerCallback()
+void StepSequencerComponent::refresh()
 {
-    int step = currentStep.load();
-    if (step != lastDisplayedStep)
+    // A new pattern length re-lays out every column
+    int length = static_cast<int> (patternLengthParam->load());
+    if (length != numSteps)
     {
-        lastDisplayedStep = step;
+        numSteps = length;
+        lastDisplayedStep = currentStep.load();
         repaint();
+        return;
     }
+
+    int step = currentStep.load();
+    if (step == lastDisplayedStep)
+        return;
+
+    // Only the step losing and the step gaining the highlight change
+    if (lastDisplayedStep >= 0 && lastDisplayedStep < numSteps)
+        repaint (getStepColumnBounds (lastDisplayedStep));
+    if (step >= 0 && step < numSteps)
+        repaint (getStepColumnBounds (step));
+
+    lastDisplayedStep = step;
 }
 
 void StepSequencerComponent::paint (juce::Graphics& g)
@@ -99,8 +126,11 @@ void StepSequencerComponent::paint (juce::Graphics& g)
 
     int activeStep = currentStep.load();
 
-    for (int i = 0; i < StepSequencer::STEP_COUNT; ++i)
+    for (int i = 0; i < numSteps; ++i)
     {
+        if (! g.clipRegionIntersects (getStepColumnBounds (i)))
+            continue;
+
         auto bounds = getBarBounds (i);
 
         // Background
@@ -108,10 +138,7 @@ void StepSequencerComponent::paint (juce::Graphics& g)
         g.fillRoundedRectangle (bounds.toFloat(), 3.0f);
 
         // Velocity bar
-        auto paramId = "step" + juce::String (i + 1);
-        float velocity = 0.0f;
-        if (auto* param = apvts.getRawParameterValue (paramId))
-            velocity = param->load();
+        float velocity = stepVelocityParams[static_cast<size_t> (i)]->load();
 
         float normalised = velocity / 127.0f;
         if (normalised > 0.0f)
@@ -140,19 +167,18 @@ void StepSequencerComponent::paint (juce::Graphics& g)
 
     // Direction arrows below bars
     auto area = getLocalBounds().reduced (4, 0);
-    auto barWidth = area.getWidth() / StepSequencer::STEP_COUNT;
+    auto barWidth = area.getWidth() / numSteps;
     auto arrowY = getLocalBounds().getBottom() - 16;
 
     g.setFont (12.0f);
-    for (int i = 0; i < StepSequencer::STEP_COUNT; ++i)
+    for (int i = 0; i < numSteps; ++i)
     {
-        auto arrowX = area.getX() + i * barWidth;
+        if (! g.clipRegionIntersects (getStepColumnBounds (i)))
+            continue;
 
-        auto dirParamId = "dir" + juce::String (i + 1);
-        int dirVal = 0;
-        if (auto* param = apvts.getRawParameterValue (dirParamId))
-            dirVal = static_cast<int> (param->load());
-        auto dir = static_cast<StepDirection> (dirVal);
+        auto arrowX = area.getX() + i * barWidth;
+        auto dir = static_cast<StepDirection> (
+            static_cast<int> (stepDirectionParams[static_cast<size_t> (i)]->load()));
 
         g.setColour (i == activeStep ? CustomLookAndFeel::accentBright : CustomLookAndFeel::textSecondary);
 
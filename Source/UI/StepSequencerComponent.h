@@ -4,8 +4,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "../StepSequencer.h"
 
-class StepSequencerComponent : public juce::Component,
-                                public juce::Timer
+class StepSequencerComponent : public juce::Component
 {
 public:
     StepSequencerComponent (juce::AudioProcessorValueTreeState& apvts,
@@ -16,15 +15,23 @@ public:
     void resized() override;
     void mouseDown (const juce::MouseEvent& event) override;
     void mouseDrag (const juce::MouseEvent& event) override;
-    void timerCallback() override;
+
+    // Called on vblank by the editor: repaints the old and new step only
+    void refresh();
 
 private:
     juce::AudioProcessorValueTreeState& apvts;
     std::atomic<int>& currentStep;
 
+    std::array<std::atomic<float>*, StepSequencer::MAX_STEPS> stepVelocityParams {};
+    std::array<std::atomic<float>*, StepSequencer::MAX_STEPS> stepDirectionParams {};
+    std::atomic<float>* patternLengthParam = nullptr;
+
     int lastDisplayedStep = -1;
+    int numSteps = StepSequencer::DEFAULT_STEPS;   // columns currently laid out
 
     juce::Rectangle<int> getBarBounds (int step) const;
+    juce::Rectangle<int> getStepColumnBounds (int step) const;
     int getStepAtPosition (juce::Point<int> pos) const;
     void setStepFromMouse (const juce::MouseEvent& event);
 
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "GuitarVoicer.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Everything the editor shows about the playing state, published by the
+// audio thread as one consistent frame
+struct UITelemetryFrame
+{
+    uint64_t version = 0;          // bumped on every published change
+    VoicingResult voicing;
+    bool voicingValid = false;
+    int step = -1;                 // -1 = transport stopped
+    uint32_t activeStrings = 0;    // bit per sounding string slot
+    int position = -1;             // fret position of the voicing
+    std::array<char, 16> chordName {};
+    double bpm = 120.0;            // host tempo
+};
+
+// "These keys were held from beat B", pushed by the audio thread while the
+// transport plays so the editor can export what was played
+struct ChordCapture
+{
+    double beat;
+    uint8_t numNotes;                 // 0 = all keys released
+    std::array<uint8_t, 15> notes;    // ascending
+};
+
+// "String N sounded at sample X with velocity V", pushed by the audio
+// thread as each strum note is emitted
+struct StringStrike
+{
+    int64_t samplePosition;   // running sample count since prepareToPlay
+    uint8_t stringIndex;      // 0 = low E
+    uint8_t velocity;
+};
+
+// Lock-free single-producer / single-consumer triple buffer.  The producer
+// fills getWriteBuffer() and calls publish(); the consumer calls fetch()
+// and reads getReadBuffer().  Neither side ever waits for the other.
+template <typename T>
+class TripleBuffer
+{
+public:
+    T& getWriteBuffer() { return buffers[static_cast<size_t> (writeIndex)]; }
+
+    void publish()
+    {
+        writeIndex = state.exchange (writeIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Swaps in the latest published buffer; returns false if nothing new
+    bool fetch()
+    {
+        if ((state.load (std::memory_order_relaxed) & FRESH_BIT) == 0)
+            return false;
+
+        readIndex = state.exchange (readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& getReadBuffer() const { return buffers[static_cast<size_t> (readIndex)]; }
+
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH_BIT  = 4;
+
+    std::array<T, 3> buffers {};
+    int writeIndex = 0;            // producer only
+    int readIndex = 1;             // consumer only
+    std::atomic<int> state { 2 };  // index of the middle buffer + FRESH_BIT
+};
@@ -0,0 +1,131 @@
+#include "VoicingPlanner.h"
+#include <map>
+#include <utility>
+
+VoicingPlanner::VoicingPlanner (GuitarVoicer& v)
+    : voicer (v)
+{
+}
+
+int VoicingPlanner::scoreTransition (int fromPosition, const VoicingResult* from,
+                                     int toPosition, const VoicingResult& to,
+                                     const VoicingParams& params)
+{
+    int referencePos = fromPosition >= 0 ? fromPosition : params.initialPosition;
+
+    int score = 0;
+    if (toPosition != 0 || referencePos == 0)
+        score += GuitarVoicer::SCORE_PROXIMITY
+                 * std::max (0, params.searchRange - std::abs (toPosition - referencePos));
+
+    if (params.voiceLeading && from != nullptr)
+        score += GuitarVoicer::scoreVoiceLeading (*from, to);
+
+    return score;
+}
+
+std::vector<VoicingPlanner::Choice> VoicingPlanner::getCandidates (const Chord& chord,
+                                                                   const VoicingParams& params)
+{
+    std::vector<Choice> candidates;
+    int maxStartFret = params.maxFret - params.fretSpan + 1;
+
+    for (int pos = 0; pos <= std::max (0, maxStartFret); ++pos)
+    {
+        auto result = voicer.findBestVoicing (chord.pitchClasses, chord.rootPitchClass, pos, params);
+        if (result.score > -10000)
+            candidates.push_back ({ result, pos });
+    }
+
+    return candidates;
+}
+
+std::vector<VoicingPlanner::Choice> VoicingPlanner::plan (const std::vector<Chord>& chords,
+                                                          const VoicingParams& params)
+{
+    std::vector<Choice> choices (chords.size());
+
+    // Candidate lists, shared between repeats of the same chord
+    std::map<std::pair<std::vector<int>, int>, std::vector<Choice>> candidatesByChord;
+    std::vector<const std::vector<Choice>*> layers (chords.size(), nullptr);
+
+    for (size_t i = 0; i < chords.size(); ++i)
+    {
+        if (chords[i].pitchClasses.empty())
+            continue;
+
+        auto key = std::make_pair (chords[i].pitchClasses, chords[i].rootPitchClass);
+        auto it = candidatesByChord.find (key);
+        if (it == candidatesByChord.end())
+            it = candidatesByChord.emplace (std::move (key), getCandidates (chords[i], params)).first;
+
+        if (! it->second.empty())
+            layers[i] = &it->second;
+    }
+
+    // Best total score ending in each candidate, and the candidate of the
+    // previous sounding chord it came from
+    std::vector<std::vector<int>> total (chords.size());
+    std::vector<std::vector<int>> cameFrom (chords.size());
+    int previousLayer = -1;
+
+    for (size_t i = 0; i < chords.size(); ++i)
+    {
+        if (layers[i] == nullptr)
+            continue;
+
+        const auto& layer = *layers[i];
+        total[i].assign (layer.size(), 0);
+        cameFrom[i].assign (layer.size(), -1);
+
+        for (size_t k = 0; k < layer.size(); ++k)
+        {
+            const auto& to = layer[k];
+
+            if (previousLayer < 0)
+            {
+                total[i][k] = to.voicing.score + scoreTransition (-1, nullptr, to.position, to.voicing, params);
+                continue;
+            }
+
+            const auto& prev = *layers[static_cast<size_t> (previousLayer)];
+            const auto& prevTotal = total[static_cast<size_t> (previousLayer)];
+            int best = 0;
+            int bestFrom = -1;
+
+            for (size_t j = 0; j < prev.size(); ++j)
+            {
+                int candidate = prevTotal[j] + scoreTransition (prev[j].position, &prev[j].voicing,
+                                                                to.position, to.voicing, params);
+                if (bestFrom < 0 || candidate > best)
+                {
+                    best = candidate;
+                    bestFrom = static_cast<int> (j);
+                }
+            }
+
+            total[i][k] = best + to.voicing.score;
+            cameFrom[i][k] = bestFrom;
+        }
+
+        previousLayer = static_cast<int> (i);
+    }
+
+    if (previousLayer < 0)
+        return choices;
+
+    // Trace the best path back from the last chord that sounded
+    const auto& lastTotal = total[static_cast<size_t> (previousLayer)];
+    int k = static_cast<int> (std::max_element (lastTotal.begin(), lastTotal.end()) - lastTotal.begin());
+
+    for (int i = previousLayer; i >= 0 && k >= 0; --i)
+    {
+        if (layers[static_cast<size_t> (i)] == nullptr)
+            continue;
+
+        choices[static_cast<size_t> (i)] = (*layers[static_cast<size_t> (i)])[static_cast<size_t> (k)];
+        k = cameFrom[static_cast<size_t> (i)][static_cast<size_t> (k)];
+    }
+
+    return choices;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "GuitarVoicer.h"
+#include <vector>
+
+// Voices a whole progression at once when every chord is known in advance.
+// Choosing each chord greedily with findBestPosition only looks one chord
+// back; the planner instead runs a Viterbi pass over (chord, candidate
+// position) pairs, maximising the sum of voicing scores plus a transition
+// score for hand movement and voice leading between neighbouring chords.
+class VoicingPlanner
+{
+public:
+    struct Chord
+    {
+        std::vector<int> pitchClasses;   // empty = nothing held
+        int rootPitchClass = 0;
+    };
+
+    struct Choice
+    {
+        VoicingResult voicing;           // score -10000 = nothing to play
+        int position = -1;
+    };
+
+    // Candidates come from the voicer's cache (or the cache it shares)
+    explicit VoicingPlanner (GuitarVoicer& voicer);
+
+    // One choice per chord.  Silent chords are skipped over, so the hand
+    // leads from the last chord that sounded, as it does when playing live.
+    std::vector<Choice> plan (const std::vector<Chord>& chords, const VoicingParams& params);
+
+    // The same proximity and voice-leading terms findBestPosition adds on
+    // top of a voicing's own score; fromPosition < 0 = nothing played yet
+    static int scoreTransition (int fromPosition, const VoicingResult* from,
+                                int toPosition, const VoicingResult& to,
+                                const VoicingParams& params);
+
+private:
+    GuitarVoicer& voicer;
+
+    // Playable voicings of one chord, one per fret position
+    std::vector<Choice> getCandidates (const Chord& chord, const VoicingParams& params);
+};
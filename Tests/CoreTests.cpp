@@ -0,0 +1,410 @@
+// Unit tests for the GuitarStrumCore engine.  Links only the JUCE-free core
+// library, so it builds in seconds; registered with CTest.
+//
+// Usage: GuitarStrumCoreTests   (exits non-zero if any check fails)
+
+#include "OfflineRenderer.h"
+#include "SongArrangement.h"
+#include "StepSequencer.h"
+#include "StrumEngine.h"
+#include "VoicingPlanner.h"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <map>
+
+namespace
+{
+    int checks = 0, failures = 0;
+
+    void expect (bool condition, const char* what, int line)
+    {
+        ++checks;
+        if (! condition)
+        {
+            ++failures;
+            std::printf ("    FAILED line %d: %s\n", line, what);
+        }
+    }
+
+    bool near (double a, double b, double tolerance = 1.0e-6) { return std::abs (a - b) <= tolerance; }
+}
+
+#define EXPECT(condition) expect ((condition), #condition, __LINE__)
+
+// Plays the sequencer through [start, end) in equal blocks
+static std::vector<StepSequencer::StepEvent> play (StepSequencer& sequencer, double start, double end,
+                                                   double blockLength = 0.1)
+{
+    std::vector<StepSequencer::StepEvent> events;
+    for (double pos = start; pos < end - 1e-9; pos += blockLength)
+    {
+        auto block = sequencer.processBlock (pos, pos + blockLength, true, false, 0.0, 0.0);
+        events.insert (events.end(), block.begin(), block.end());
+    }
+    return events;
+}
+
+static const StepSequencer::StepEvent* findEventAt (const std::vector<StepSequencer::StepEvent>& events, double beat)
+{
+    for (const auto& e : events)
+        if (near (e.beatPosition, beat))
+            return &e;
+    return nullptr;
+}
+
+// ── SongArrangement ───────────────────────────────────────────────────
+
+static void testArrangementFind()
+{
+    StepSequencer::Pattern a, b;
+    a.numSteps = 4;
+    b.numSteps = 5;
+
+    // Bar 2 plays A, bar 3 B, bar 4 nothing, bar 5 A again
+    SongArrangement arrangement ({ a, b }, { { 0, 2, 2 }, { 1, 3, 3 }, { 0, 5, 5 } });
+    EXPECT (arrangement.getNumSpans() == 4);
+
+    auto before = arrangement.find (2.0);
+    EXPECT (before.pattern == nullptr && near (before.endBeat, 4.0));
+
+    auto first = arrangement.find (4.0);
+    EXPECT (first.pattern != nullptr && first.pattern->numSteps == 4);
+    EXPECT (near (first.startBeat, 4.0) && near (first.endBeat, 8.0));
+
+    EXPECT (arrangement.find (7.99).pattern == first.pattern);
+    EXPECT (arrangement.find (8.0).pattern != nullptr && arrangement.find (8.0).pattern->numSteps == 5);
+
+    auto gap = arrangement.find (13.0);
+    EXPECT (gap.pattern == nullptr && near (gap.startBeat, 12.0) && near (gap.endBeat, 16.0));
+
+    EXPECT (arrangement.find (16.0).pattern == first.pattern);
+
+    auto after = arrangement.find (25.0);
+    EXPECT (after.pattern == nullptr && near (after.startBeat, 20.0));
+
+    // Later sections win where they overlap; unknown patterns are ignored
+    SongArrangement overlapping ({ a, b }, { { 0, 1, 4 }, { 1, 2, 3 }, { 7, 1, 8 } });
+    EXPECT (overlapping.getNumSpans() == 3);
+    EXPECT (overlapping.find (5.0).pattern->numSteps == 5);
+    EXPECT (overlapping.find (12.0).pattern->numSteps == 4);
+
+    SongArrangement empty ({ a }, { { 3, 1, 2 } });
+    EXPECT (empty.getNumSpans() == 0 && empty.find (0.0).pattern == nullptr);
+}
+
+// ── StepSequencer ─────────────────────────────────────────────────────
+
+static void testSectionReseek()
+{
+    StepSequencer::Pattern a, b;
+    a.numSteps = 4;                 // 8ths
+    b.numSteps = 5;
+    b.subdivisionIndex = 2;         // 8th triplets
+    b.velocities.fill (50.0f);
+    SongArrangement arrangement ({ a, b }, { { 0, 2, 2 }, { 1, 3, 3 } });
+
+    StepSequencer sequencer;
+    sequencer.setPattern (2, 0);
+    sequencer.setArrangement (&arrangement);
+    auto events = play (sequencer, 0.0, 16.0);
+
+    // Each section starts its pattern from step 0 at the section start
+    auto* sectionA = findEventAt (events, 4.0);
+    EXPECT (sectionA != nullptr && sectionA->stepIndex == 0);
+
+    auto* sectionB = findEventAt (events, 8.0);
+    EXPECT (sectionB != nullptr && sectionB->stepIndex == 0 && sectionB->velocity == 50.0f);
+
+    auto* wrapB = findEventAt (events, 8.0 + 5.0 / 3.0);
+    EXPECT (wrapB != nullptr && wrapB->stepIndex == 0);
+
+    auto* live = findEventAt (events, 12.0);
+    EXPECT (live != nullptr && live->stepIndex == 0 && live->velocity != 50.0f);
+
+    for (const auto& e : events)
+        EXPECT (e.beatPosition < 8.0 || e.beatPosition >= 12.0 || e.velocity == 50.0f);
+
+    // Starting mid-section finds the step relative to the section, not the song
+    StepSequencer seeking;
+    seeking.setArrangement (&arrangement);
+    auto fromMiddle = play (seeking, 10.0, 10.5);
+    EXPECT (! fromMiddle.empty() && near (fromMiddle.front().beatPosition, 10.0));
+    EXPECT (! fromMiddle.empty() && fromMiddle.front().stepIndex == 1);
+}
+
+static void testCycleWrap()
+{
+    // A cycle that isn't a whole number of steps plays from step 0 each pass
+    struct Loop { int subdivision; int numSteps; double start, end; int lastStep; };
+    const Loop loops[] = { { 5, 16, 0.0, 4.0, 10 },     // dotted 16ths: 10 2/3 steps
+                           { 0, 16, 0.0, 0.75, 1 },     // 8ths: 1 1/2 steps
+                           { 1, 16, 2.0, 6.0, 15 } };   // 16ths, offset loop
+
+    for (const auto& loop : loops)
+    {
+        StepSequencer sequencer;
+        sequencer.setPattern (loop.numSteps, loop.subdivision);
+
+        std::array<int, StepSequencer::MAX_STEPS> counts {};
+        double blockLength = 512 * 2.0 / 48000.0;   // 512 samples at 48 kHz, 120 BPM
+        double pos = loop.start;
+        int passes = 0;
+
+        for (int block = 0; block < 4000; ++block)
+        {
+            for (const auto& e : sequencer.processBlock (pos, pos + blockLength, true, true, loop.start, loop.end))
+                ++counts[static_cast<size_t> (e.stepIndex)];
+
+            pos += blockLength;
+            if (pos >= loop.end)
+            {
+                pos -= loop.end - loop.start;
+                ++passes;
+            }
+        }
+
+        for (int step = 0; step < loop.numSteps; ++step)
+        {
+            auto count = counts[static_cast<size_t> (step)];
+            if (step <= loop.lastStep)
+                EXPECT (count >= passes && count <= passes + 1);
+            else
+                EXPECT (count == 0);
+        }
+    }
+}
+
+// ── Grooves ───────────────────────────────────────────────────────────
+
+static void testGrooveResolve()
+{
+    StepSequencer sequencer;
+    sequencer.setPattern (4, 0);
+    for (int i = 0; i < 4; ++i)
+        sequencer.setStepVelocity (i, 100.0f);
+
+    sequencer.setGroove (GrooveTemplate::getPreset (1), 1.0f);   // swing
+    auto swung = play (sequencer, 0.0, 2.0);
+
+    auto* onBeat = findEventAt (swung, 0.0);
+    auto* offBeat = findEventAt (swung, 0.5 + 0.33 * 0.5);
+    EXPECT (onBeat != nullptr && onBeat->stepIndex == 0 && onBeat->velocity == 100.0f);
+    EXPECT (offBeat != nullptr && offBeat->stepIndex == 1 && near (offBeat->velocity, 85.0, 1.0e-3));
+
+    // Looking a step up reports it as it was played
+    auto lookedUp = sequencer.getStepAt (2.7);
+    EXPECT (lookedUp.stepIndex == 1 && near (lookedUp.beatPosition, 2.5 + 0.33 * 0.5));
+    EXPECT (near (lookedUp.velocity, 85.0, 1.0e-3));
+
+    // Half the amount, half the deviation
+    StepSequencer halfSwung;
+    halfSwung.setPattern (4, 0);
+    for (int i = 0; i < 4; ++i)
+        halfSwung.setStepVelocity (i, 100.0f);
+    halfSwung.setGroove (GrooveTemplate::getPreset (1), 0.5f);
+    auto halfEvents = play (halfSwung, 0.0, 1.0);
+    auto* half = findEventAt (halfEvents, 0.5 + 0.33 * 0.25);
+    EXPECT (half != nullptr && near (half->velocity, 92.5, 1.0e-3));
+
+    // Offsets stop short of the neighbouring steps, so order is kept
+    GrooveTemplate late;
+    late.numSteps = 1;
+    late.steps[0] = { 0.5f, 1.0f, 1.5f };
+
+    StepSequencer dragging;
+    dragging.setPattern (4, 0);
+    for (int i = 0; i < 4; ++i)
+        dragging.setStepVelocity (i, 100.0f);
+    dragging.setGroove (late, 1.0f);
+    auto dragged = play (dragging, 0.0, 4.0);
+
+    EXPECT (! dragged.empty() && near (dragged.front().beatPosition, 0.45 * 0.5));
+    EXPECT (! dragged.empty() && near (dragged.front().strumSpeedScale, 1.5));
+    for (size_t i = 1; i < dragged.size(); ++i)
+        EXPECT (dragged[i].beatPosition > dragged[i - 1].beatPosition);
+}
+
+static void testGrooveExtract()
+{
+    // Swung 8ths: off-beats 0.32 of a step late and half as loud
+    auto swing = GrooveTemplate::extract ({ { 0.0, 100 }, { 0.66, 50 }, { 1.0, 100 }, { 1.66, 50 } }, 0.5, 2);
+    EXPECT (swing.numSteps == 2);
+    EXPECT (near (swing.steps[0].timing, 0.0, 1.0e-4) && near (swing.steps[1].timing, 0.32, 1.0e-4));
+    EXPECT (near (swing.steps[0].velocity, 4.0 / 3.0, 1.0e-4) && near (swing.steps[1].velocity, 2.0 / 3.0, 1.0e-4));
+    EXPECT (swing.steps[0].strumSpeed == 1.0f && swing.steps[1].strumSpeed == 1.0f);
+
+    // One loud, spread strum among quiet single notes goes past the limits
+    std::vector<GrooveTemplate::Hit> hits { { 0.0, 127 }, { 0.03, 127 } };
+    for (int i = 1; i < 8; ++i)
+        hits.push_back ({ i * 0.25, 1 });
+
+    auto extreme = GrooveTemplate::extract (hits, 0.25, 8);
+    EXPECT (extreme.steps[0].velocity == GrooveTemplate::Step::MAX_VELOCITY);
+    EXPECT (extreme.steps[0].strumSpeed == GrooveTemplate::Step::MAX_STRUM_SPEED);
+    for (int i = 0; i < extreme.numSteps; ++i)
+        EXPECT (extreme.steps[static_cast<size_t> (i)] == extreme.steps[static_cast<size_t> (i)].limited());
+}
+
+// ── StrumEngine ───────────────────────────────────────────────────────
+
+namespace
+{
+    struct QueuedEvent
+    {
+        long long tick;
+        uint8_t status, data1, data2;
+        int8_t slot;
+
+        bool isNoteOn() const { return (status & 0xf0) == 0x90 && data2 > 0; }
+    };
+}
+
+static void testWithdrawStrikes()
+{
+    auto tickOf = [] (const QueuedEvent& e) { return e.tick; };
+
+    // Slot 0 sounds 40; the next strum's choke of 40 and strike of 45 are queued
+    StrumEngine engine;
+    engine.generateStrum ({ { 0, 40 } }, StepDirection::Down, 100.0f, 10.0f, 0.0f, false, 120.0, 0.0);
+    engine.generateStrum ({ { 0, 45 } }, StepDirection::Down, 100.0f, 10.0f, 0.0f, false, 120.0, 1.0);
+
+    std::vector<QueuedEvent> queue { { 100, 0x80, 40, 0, 0 }, { 100, 0x90, 45, 100, 0 }, { 150, 0x80, 45, 0, 0 },
+                                     { 100, 0x90, 52, 100, 1 } };
+    engine.withdrawStrikes (queue, 1u, -1LL, tickOf);
+
+    // Slot 0's strike goes with its choke and later NoteOff; slot 1 is not in the mask
+    EXPECT (queue.size() == 1 && queue[0].slot == 1);
+    EXPECT (engine.getSlot (0).pitch == 40);
+
+    auto restrike = engine.generateStrum ({ { 0, 40 } }, StepDirection::Down, 100.0f, 10.0f, 0.0f, false, 120.0, 2.0);
+    EXPECT (restrike.size() == 1 && restrike[0].chokePitch == 40);
+
+    // Strikes that have sounded stay, as does everything before `first`
+    StrumEngine history;
+    history.generateStrum ({ { 0, 45 } }, StepDirection::Down, 100.0f, 10.0f, 0.0f, false, 120.0, 0.0);
+    std::vector<QueuedEvent> events { { 300, 0x90, 40, 100, 0 }, { 50, 0x90, 45, 100, 0 }, { 200, 0x90, 47, 100, 0 } };
+    history.withdrawStrikes (events, ~0u, 100LL, tickOf, 1);
+    EXPECT (events.size() == 2 && events[0].tick == 300 && events[1].tick == 50);
+}
+
+static void testOfflineRenderPairs()
+{
+    // Every NoteOn is closed before its pitch strikes again, and nothing hangs
+    OfflineRenderer renderer (nullptr);
+    StrumSettings settings;
+    settings.subdivisionIndex = 1;
+    settings.strumSpeedMs = 30.0f;
+    settings.voicingEnabled = true;
+
+    auto events = renderer.render (settings, { { 0.0, { 48, 52, 55 } }, { 2.0, { 50, 53, 57 } }, { 3.9, {} } },
+                                   { { 0.0, 120.0 } }, 4.0);
+    EXPECT (! events.empty());
+
+    std::map<int, bool> sounding;
+    for (const auto& e : events)
+    {
+        auto& on = sounding[(e.status & 0x0f) * 128 + e.data1];
+        if (e.isNoteOn())
+            EXPECT (! on);
+        on = e.isNoteOn();
+    }
+
+    for (const auto& entry : sounding)
+        EXPECT (! entry.second);
+}
+
+// ── VoicingPlanner ────────────────────────────────────────────────────
+
+static void testPlannerIsOptimal()
+{
+    GuitarVoicer voicer;
+    VoicingParams params;
+    params.openPitches = voicer.getStringOpenPitches (0, 0);
+    params = GuitarVoicer::withOfflineQuality (params);
+
+    std::vector<VoicingPlanner::Chord> chords { { { 0, 4, 7 }, 0 }, { { 9, 0, 4 }, 9 }, { {}, 0 },
+                                                { { 5, 9, 0 }, 5 }, { { 7, 11, 2 }, 7 } };
+    auto plan = VoicingPlanner (voicer).plan (chords, params);
+    EXPECT (plan.size() == chords.size());
+    EXPECT (plan[2].voicing.score == -10000);
+
+    // The same candidates the planner draws from, one per position
+    std::vector<std::vector<VoicingPlanner::Choice>> candidates;
+    for (const auto& chord : chords)
+    {
+        if (chord.pitchClasses.empty())
+            continue;
+
+        candidates.emplace_back();
+        for (int pos = 0; pos <= params.maxFret - params.fretSpan + 1; ++pos)
+        {
+            auto result = voicer.findBestVoicing (chord.pitchClasses, chord.rootPitchClass, pos, params);
+            if (result.score > -10000)
+                candidates.back().push_back ({ result, pos });
+        }
+    }
+
+    auto totalOf = [&params] (const std::vector<const VoicingPlanner::Choice*>& path)
+    {
+        int total = 0;
+        const VoicingPlanner::Choice* previous = nullptr;
+        for (const auto* choice : path)
+        {
+            total += choice->voicing.score
+                   + VoicingPlanner::scoreTransition (previous != nullptr ? previous->position : -1,
+                                                      previous != nullptr ? &previous->voicing : nullptr,
+                                                      choice->position, choice->voicing, params);
+            previous = choice;
+        }
+        return total;
+    };
+
+    std::vector<const VoicingPlanner::Choice*> planned;
+    for (const auto& choice : plan)
+        if (choice.voicing.score > -10000)
+            planned.push_back (&choice);
+    EXPECT (planned.size() == candidates.size());
+
+    // No path through the candidates beats the planned one
+    int best = std::numeric_limits<int>::min();
+    std::vector<size_t> index (candidates.size(), 0);
+    for (;;)
+    {
+        std::vector<const VoicingPlanner::Choice*> path;
+        for (size_t i = 0; i < candidates.size(); ++i)
+            path.push_back (&candidates[i][index[i]]);
+        best = std::max (best, totalOf (path));
+
+        size_t digit = 0;
+        while (digit < index.size() && ++index[digit] == candidates[digit].size())
+            index[digit++] = 0;
+        if (digit == index.size())
+            break;
+    }
+
+    EXPECT (totalOf (planned) == best);
+}
+
+int main()
+{
+    const std::pair<const char*, void (*)()> tests[] = {
+        { "SongArrangement::find", testArrangementFind },
+        { "section re-seek", testSectionReseek },
+        { "cycle wrap", testCycleWrap },
+        { "groove resolve", testGrooveResolve },
+        { "groove extract", testGrooveExtract },
+        { "withdrawStrikes", testWithdrawStrikes },
+        { "offline render note pairs", testOfflineRenderPairs },
+        { "planner optimality", testPlannerIsOptimal },
+    };
+
+    for (const auto& test : tests)
+    {
+        std::printf ("%s\n", test.first);
+        test.second();
+    }
+
+    std::printf ("%d checks, %d failed\n", checks, failures);
+    return failures == 0 ? 0 : 1;
+}
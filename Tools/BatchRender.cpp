@@ -0,0 +1,264 @@
+// Offline batch renderer: chord MIDI files in, strummed MIDI files out.
+//
+// Every note in the input (except channel 10) is read as the chord being
+// held, and the file's tempo map drives the strum timing.  Each file is
+// rendered through the sequencer → voicer → strum pipeline in one pass and
+// written with the same resolution and tempo/time-signature events.  Files
+// are spread across worker threads that share one voicing cache.
+//
+// Usage: GuitarStrumBatch --preset <preset.json> --out <dir> [--jobs N] <file.mid|dir>...
+//
+// Preset (all keys optional, defaults match the plugin):
+//   { "subdivision": "8th" | "16th" | "8th triplet" | "16th triplet" | "dotted 8th" | "dotted 16th",
+//     "strumSpeedMs": 8, "humanize": 50,
+//     "groove": "Off" | "Swing" | "Laid Back" | "Push" | "<groove.json or reference.mid>",
+//     "grooveAmount": 100,
+//     "voicing": true, "multiChannel": false, "tuning": "Standard" | 0-4,
+//     "capo": 0, "fretSpan": 4, "maxFret": 12, "preferOpenStrings": true,
+//     "searchRange": 5, "initialPosition": 0, "offlineQuality": true,
+//     "steps": [ { "velocity": 107, "direction": "down" | "up" | "rest", "length": 1 }, ... ] }
+//   "steps" holds 1-64 entries and sets the pattern length; "length" is in grid steps.
+//   A groove file path is relative to the preset.
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "OfflineRenderer.h"
+#include "MidiClipWriter.h"
+#include "GrooveFile.h"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+static const juce::StringArray tuningNames { "Standard", "Drop D", "Open G", "DADGAD", "Half Step Down" };
+static const juce::StringArray subdivisionNames { "8th", "16th", "8th triplet", "16th triplet", "dotted 8th", "dotted 16th" };
+
+static bool loadPreset (const juce::File& file, StrumSettings& settings)
+{
+    auto json = juce::JSON::parse (file);
+    if (! json.isObject())
+        return false;
+
+    auto get = [&json] (const char* key, const juce::var& fallback)
+    {
+        return json.hasProperty (key) ? json[key] : fallback;
+    };
+
+    settings.subdivisionIndex = juce::jmax (0, subdivisionNames.indexOf (get ("subdivision", "8th").toString(), true));
+    settings.strumSpeedMs = juce::jlimit (5.0f, 50.0f, static_cast<float> (get ("strumSpeedMs", 8.0)));
+    settings.humanize = juce::jlimit (0.0f, 1.0f, static_cast<float> (get ("humanize", 50.0)) / 100.0f);
+    settings.grooveAmount = juce::jlimit (0.0f, 1.0f, static_cast<float> (get ("grooveAmount", 100.0)) / 100.0f);
+
+    auto groove = get ("groove", "Off").toString();
+    auto presetIndex = GrooveFile::presetNames.indexOf (groove, true);
+    if (presetIndex >= 0)
+    {
+        settings.groove = GrooveTemplate::getPreset (presetIndex);
+    }
+    else
+    {
+        juce::String error;
+        auto grid = StepSequencer::SUBDIVISION_BEATS[static_cast<size_t> (settings.subdivisionIndex)];
+        if (! GrooveFile::load (file.getSiblingFile (groove), grid, settings.groove, error))
+        {
+            std::fprintf (stderr, "%s: %s\n", groove.toRawUTF8(), error.toRawUTF8());
+            return false;
+        }
+    }
+    settings.voicingEnabled = get ("voicing", true);
+    settings.multiChannel = get ("multiChannel", false);
+
+    auto tuning = get ("tuning", 0);
+    settings.tuningIndex = tuning.isString() ? juce::jmax (0, tuningNames.indexOf (tuning.toString(), true))
+                                             : juce::jlimit (0, GuitarVoicer::NUM_TUNINGS - 1, static_cast<int> (tuning));
+
+    settings.capo = juce::jlimit (0, 12, static_cast<int> (get ("capo", 0)));
+    settings.fretSpan = juce::jlimit (3, 5, static_cast<int> (get ("fretSpan", 4)));
+    settings.maxFret = juce::jlimit (5, 15, static_cast<int> (get ("maxFret", 12)));
+    settings.preferOpen = get ("preferOpenStrings", true);
+    settings.searchRange = juce::jlimit (2, 7, static_cast<int> (get ("searchRange", 5)));
+    settings.initialPosition = juce::jlimit (0, 12, static_cast<int> (get ("initialPosition", 0)));
+    settings.offlineQuality = get ("offlineQuality", true);
+
+    if (auto* steps = json["steps"].getArray())
+    {
+        settings.numSteps = juce::jlimit (1, StepSequencer::MAX_STEPS, steps->size());
+
+        for (int i = 0; i < settings.numSteps; ++i)
+        {
+            const auto& step = steps->getReference (i);
+            auto index = static_cast<size_t> (i);
+
+            settings.stepVelocities[index] = juce::jlimit (0.0f, 127.0f, static_cast<float> (step["velocity"]));
+            if (step.hasProperty ("length"))
+                settings.stepLengths[index] = juce::jlimit (0.25f, 4.0f, static_cast<float> (step["length"]));
+
+            auto direction = step["direction"].toString().toLowerCase();
+            settings.stepDirections[index] = direction == "up"   ? StepDirection::Up
+                                           : direction == "rest" ? StepDirection::Rest
+                                                                 : StepDirection::Down;
+        }
+    }
+
+    return true;
+}
+
+// Renders one chord file; returns an error message, or empty on success
+static juce::String renderFile (const juce::File& input, const juce::File& output,
+                                const StrumSettings& settings, OfflineRenderer& renderer)
+{
+    juce::FileInputStream in (input);
+    juce::MidiFile midiFile;
+    if (! in.openedOk() || ! midiFile.readFrom (in))
+        return "not a readable MIDI file";
+
+    int ticksPerQuarter = midiFile.getTimeFormat();
+    if (ticksPerQuarter <= 0)
+        return "SMPTE time format is not supported";
+
+    const double tpq = static_cast<double> (ticksPerQuarter);
+
+    // Tempo map
+    juce::MidiMessageSequence tempoEvents;
+    midiFile.findAllTempoEvents (tempoEvents);
+    std::vector<TempoChange> tempos;
+    for (const auto* e : tempoEvents)
+        tempos.push_back ({ e->message.getTimeStamp() / tpq, 60.0 / e->message.getTempoSecondsPerQuarterNote() });
+
+    // Flatten every track's notes into one list of held-chord changes
+    juce::MidiMessageSequence notes;
+    juce::MidiMessageSequence meta;
+    for (int t = 0; t < midiFile.getNumTracks(); ++t)
+    {
+        for (const auto* e : *midiFile.getTrack (t))
+        {
+            const auto& msg = e->message;
+            if (msg.isNoteOnOrOff() && msg.getChannel() != 10)
+                notes.addEvent (msg);
+            else if (msg.isTempoMetaEvent() || msg.isTimeSignatureMetaEvent() || msg.isKeySignatureMetaEvent())
+                meta.addEvent (msg);
+        }
+    }
+    notes.sort();
+    meta.sort();
+
+    std::vector<ChordChange> chords;
+    std::vector<int> held;
+    for (int i = 0; i < notes.getNumEvents();)
+    {
+        auto tick = notes.getEventTime (i);
+
+        // All events at one timestamp form a single change: offs first
+        std::vector<int> ons;
+        for (; i < notes.getNumEvents() && notes.getEventTime (i) == tick; ++i)
+        {
+            const auto& msg = notes.getEventPointer (i)->message;
+            if (msg.isNoteOn())
+                ons.push_back (msg.getNoteNumber());
+            else
+                held.erase (std::remove (held.begin(), held.end(), msg.getNoteNumber()), held.end());
+        }
+
+        for (auto n : ons)
+            if (std::find (held.begin(), held.end(), n) == held.end())
+                held.push_back (n);
+        std::sort (held.begin(), held.end());
+
+        if (chords.empty() || chords.back().notes != held)
+            chords.push_back ({ tick / tpq, held });
+    }
+
+    double endBeat = std::ceil (midiFile.getLastTimestamp() / tpq);
+    auto events = renderer.render (settings, chords, tempos, endBeat);
+
+    // Write: conductor track (tempo/meter) + strummed guitar track
+    output.deleteFile();
+    juce::FileOutputStream out (output);
+    if (! out.openedOk() || ! MidiClipWriter::write (out, events, endBeat, ticksPerQuarter, meta))
+        return "could not write " + output.getFullPathName();
+
+    return {};
+}
+
+int main (int argc, char* argv[])
+{
+    juce::File presetFile, outDir;
+    int jobs = static_cast<int> (std::max (1u, std::thread::hardware_concurrency()));
+    juce::Array<juce::File> inputs;
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg (argv[i]);
+
+        if (arg == "--preset" && i + 1 < argc)
+            presetFile = cwd.getChildFile (argv[++i]);
+        else if (arg == "--out" && i + 1 < argc)
+            outDir = cwd.getChildFile (argv[++i]);
+        else if (arg == "--jobs" && i + 1 < argc)
+            jobs = juce::jmax (1, juce::String (argv[++i]).getIntValue());
+        else if (cwd.getChildFile (arg).isDirectory())
+            inputs.addArray (cwd.getChildFile (arg).findChildFiles (juce::File::findFiles, false, "*.mid;*.midi"));
+        else
+            inputs.add (cwd.getChildFile (arg));
+    }
+
+    if (outDir == juce::File() || inputs.isEmpty())
+    {
+        std::printf ("Usage: GuitarStrumBatch --preset <preset.json> --out <dir> [--jobs N] <file.mid|dir>...\n");
+        return 2;
+    }
+
+    StrumSettings settings;
+    if (presetFile != juce::File() && ! loadPreset (presetFile, settings))
+    {
+        std::printf ("Could not read preset %s\n", presetFile.getFullPathName().toRawUTF8());
+        return 2;
+    }
+
+    outDir.createDirectory();
+
+    // Workers claim the next unrendered file until none are left, so long
+    // songs never hold up a queue of short ones
+    SharedVoicingCache voicingCache;
+    std::atomic<int> nextFile { 0 };
+    std::vector<juce::String> errors (static_cast<size_t> (inputs.size()));
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < juce::jmin (jobs, inputs.size()); ++w)
+    {
+        workers.emplace_back ([&]
+        {
+            OfflineRenderer renderer (&voicingCache);
+
+            for (int i = nextFile++; i < inputs.size(); i = nextFile++)
+            {
+                const auto& input = inputs.getReference (i);
+                errors[static_cast<size_t> (i)] = renderFile (input, outDir.getChildFile (input.getFileName()),
+                                                              settings, renderer);
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+    int failed = 0;
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        const auto& error = errors[static_cast<size_t> (i)];
+        if (error.isNotEmpty())
+        {
+            ++failed;
+            std::printf ("%s: %s\n", inputs.getReference (i).getFullPathName().toRawUTF8(), error.toRawUTF8());
+        }
+    }
+
+    std::printf ("Rendered %d of %d files in %.3f s on %d threads (%d cached voicings)\n",
+                 inputs.size() - failed, inputs.size(), elapsed, static_cast<int> (workers.size()),
+                 static_cast<int> (voicingCache.size()));
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+// Headless replay of a black-box recording (.gsbb).
+//
+// Restores the recorded plugin state and processing mode, feeds every
+// recorded block's input MIDI, transport state and block size through a
+// fresh processor as fast as possible, and diffs the MIDI it produces
+// against the MIDI the plugin produced in the original session.  Exits non-zero on any difference.
+//
+// Usage: GuitarStrumReplay <recording.gsbb> [max differences to print]
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PluginProcessor.h"
+#include "BlackBoxRecorder.h"
+#include <cstdio>
+#include <cstdlib>
+
+// Plays back the transport state captured with each block
+struct ReplayPlayHead : public juce::AudioPlayHead
+{
+    const BlackBoxRecording::Block* block = nullptr;
+
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        if (block == nullptr || (block->flags & BlackBoxRecording::HasPosition) == 0)
+            return {};
+
+        PositionInfo info;
+        info.setIsPlaying ((block->flags & BlackBoxRecording::IsPlaying) != 0);
+        info.setIsLooping ((block->flags & BlackBoxRecording::IsLooping) != 0);
+        if ((block->flags & BlackBoxRecording::HasBpm) != 0)
+            info.setBpm (block->bpm);
+        if ((block->flags & BlackBoxRecording::HasPpq) != 0)
+            info.setPpqPosition (block->ppq);
+        if ((block->flags & BlackBoxRecording::HasLoopPoints) != 0)
+            info.setLoopPoints (LoopPoints { block->loopStart, block->loopEnd });
+        return info;
+    }
+};
+
+static juce::String describe (const BlackBoxRecording::MidiEvent& e)
+{
+    juce::String text ("@" + juce::String (e.samplePosition));
+    for (int i = 0; i < e.size; ++i)
+        text << " " << juce::String::toHexString (static_cast<int> (e.bytes[i])).paddedLeft ('0', 2);
+    return text;
+}
+
+static bool sameEvent (const BlackBoxRecording::MidiEvent& a, const BlackBoxRecording::MidiEvent& b)
+{
+    return a.samplePosition == b.samplePosition && a.size == b.size
+        && std::equal (a.bytes, a.bytes + a.size, b.bytes);
+}
+
+int main (int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::printf ("Usage: GuitarStrumReplay <recording.gsbb> [max differences to print]\n");
+        return 2;
+    }
+
+    int maxReported = argc > 2 ? std::max (1, std::atoi (argv[2])) : 20;
+
+    juce::File file (juce::File::getCurrentWorkingDirectory().getChildFile (argv[1]));
+    juce::FileInputStream in (file);
+    BlackBoxRecording recording;
+
+    if (! in.openedOk() || ! BlackBoxRecording::readFrom (in, recording))
+    {
+        std::printf ("Could not read %s\n", file.getFullPathName().toRawUTF8());
+        return 2;
+    }
+
+    int maxBlockSize = 1;
+    double seconds = 0.0;
+    for (const auto& block : recording.blocks)
+    {
+        maxBlockSize = std::max (maxBlockSize, block.numSamples);
+        seconds += block.numSamples / recording.sampleRate;
+    }
+
+    std::printf ("%d blocks, %.2f s at %.0f Hz%s%s\n", static_cast<int> (recording.blocks.size()),
+                 seconds, recording.sampleRate,
+                 recording.nonRealtime ? ", offline" : "",
+                 recording.startsAtPrepare ? "" : " (starts mid-session: early blocks may differ)");
+
+    ReplayPlayHead playHead;
+    GuitarStrumSequencerProcessor processor;
+    processor.setStateInformation (recording.pluginState.getData(),
+                                   static_cast<int> (recording.pluginState.getSize()));
+    processor.setPlayHead (&playHead);
+    processor.setNonRealtime (recording.nonRealtime);
+    processor.prepareToPlay (recording.sampleRate, maxBlockSize);
+
+    juce::AudioBuffer<float> audio (0, maxBlockSize);
+    juce::MidiBuffer midi;
+    int differingBlocks = 0, reported = 0;
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (size_t i = 0; i < recording.blocks.size(); ++i)
+    {
+        const auto& block = recording.blocks[i];
+        playHead.block = &block;
+
+        midi.clear();
+        for (const auto& e : block.input)
+            midi.addEvent (e.bytes, e.size, e.samplePosition);
+
+        audio.setSize (0, block.numSamples, false, false, true);
+        processor.processBlock (audio, midi);
+
+        auto produced = BlackBoxRecording::toEvents (midi);
+        bool same = produced.size() == block.output.size()
+                 && std::equal (produced.begin(), produced.end(), block.output.begin(), sameEvent);
+
+        if (same)
+            continue;
+
+        ++differingBlocks;
+        if (reported++ < maxReported)
+        {
+            std::printf ("block %d (ppq %.4f, %d samples)\n", static_cast<int> (i), block.ppq, block.numSamples);
+            for (const auto& e : block.output)
+                std::printf ("    recorded %s\n", describe (e).toRawUTF8());
+            for (const auto& e : produced)
+                std::printf ("    replayed %s\n", describe (e).toRawUTF8());
+        }
+    }
+
+    auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+    processor.setPlayHead (nullptr);
+
+    std::printf ("%d of %d blocks differ; replayed in %.3f s (%.0fx real time)\n",
+                 differingBlocks, static_cast<int> (recording.blocks.size()), elapsed,
+                 elapsed > 0.0 ? seconds / elapsed : 0.0);
+
+    return differingBlocks == 0 ? 0 : 1;
+}